@@ -1,9 +1,15 @@
 #include "assert.h"
+#define SATC_ALLOC_STATS
 #include "satc.h"
 
+#ifdef SATC_USE_FLOAT
+#define SATC_TEST_EPSILON 0.001
+#else
 #define SATC_TEST_EPSILON 0.0001
+#endif
 #define satc_assert_near(actual, expected) assert(fabs((actual) - (expected)) < SATC_TEST_EPSILON)
 #define satc_nearest_hundredth(n) floor(n * 100 + 0.5) / 100
+#define satc_world_dirty(polygon) ((polygon)->dirty & (SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES))
 
 void satc_point_scale_xy_test () {
   satc_point_alloca(v);
@@ -46,6 +52,60 @@ void satc_point_scale_xy_test () {
   satc_assert_near(satc_point_get_y(v), 4.0);
 }
 
+void satc_vec2_test () {
+  satc_vec2_t v = satc_vec2(5.0, 5.0);
+  v = satc_vec2_scale(v, 10.0);
+  assert(v.x == 50.0);
+  assert(v.y == 50.0);
+
+  v = satc_vec2_add(satc_vec2(1.0, 2.0), satc_vec2(3.0, 4.0));
+  assert(v.x == 4.0);
+  assert(v.y == 6.0);
+  v = satc_vec2_sub(v, satc_vec2(1.0, 1.0));
+  assert(v.x == 3.0);
+  assert(v.y == 5.0);
+  assert(satc_vec2_dot(satc_vec2(3.0, 4.0), satc_vec2(3.0, 4.0)) == 25.0);
+  satc_assert_near(satc_vec2_len(satc_vec2(3.0, 4.0)), 5.0);
+
+  v = satc_vec2_perp(satc_vec2(1.0, 2.0));
+  assert(v.x == 2.0);
+  assert(v.y == -1.0);
+  v = satc_vec2_reverse(v);
+  assert(v.x == -2.0);
+  assert(v.y == 1.0);
+
+  v = satc_vec2_rotate(satc_vec2(1.0, 1.0), M_PI / 4.0);
+  satc_assert_near(v.x, 0.0);
+  satc_assert_near(v.y, sqrt(2.0));
+
+  v = satc_vec2_normalize(satc_vec2(3.0, 4.0));
+  satc_assert_near(v.x, 0.6);
+  satc_assert_near(v.y, 0.8);
+  v = satc_vec2_normalize(satc_vec2(0.0, 0.0));
+  assert(v.x == 0.0);
+  assert(v.y == 0.0);
+
+  satc_vec2_t axis = satc_vec2(1.0, 0.0);
+  v = satc_vec2_project(satc_vec2(3.0, 4.0), axis);
+  satc_assert_near(v.x, 3.0);
+  satc_assert_near(v.y, 0.0);
+  v = satc_vec2_reflect(satc_vec2(3.0, 4.0), axis);
+  satc_assert_near(v.x, 3.0);
+  satc_assert_near(v.y, -4.0);
+  v = satc_vec2_reflect_n(satc_vec2(3.0, 4.0), axis);
+  satc_assert_near(v.x, 3.0);
+  satc_assert_near(v.y, -4.0);
+  v = satc_vec2_project(satc_vec2(3.0, 4.0), satc_vec2(0.0, 0.0));
+  satc_assert_near(v.x, 3.0);
+  satc_assert_near(v.y, 4.0);
+
+  satc_point_alloca(p);
+  satc_vec2_store(p, satc_vec2(7.0, 8.0));
+  v = satc_vec2_load(p);
+  assert(v.x == 7.0);
+  assert(v.y == 8.0);
+}
+
 void satc_polygon_get_centroid_test () {
   {
     // Centroid of a square
@@ -65,7 +125,7 @@ void satc_polygon_get_centroid_test () {
     points[2] = c;
     points[3] = d;
     satc_polygon_t *polygon = satc_polygon_create(pos, 4, points);
-    double *centroid = satc_polygon_get_centroid(polygon);
+    SATC_REAL *centroid = satc_polygon_get_centroid(polygon);
     satc_assert_near(satc_point_get_x(centroid), 20.0);
     satc_assert_near(satc_point_get_y(centroid), 20.0);
     satc_point_destroy(centroid);
@@ -87,7 +147,7 @@ void satc_polygon_get_centroid_test () {
     points[1] = b;
     points[2] = c;
     satc_polygon_t *polygon = satc_polygon_create(pos, 3, points);
-    double *centroid = satc_polygon_get_centroid(polygon);
+    SATC_REAL *centroid = satc_polygon_get_centroid(polygon);
     satc_assert_near(satc_point_get_x(centroid), 50.0);
     satc_assert_near(satc_point_get_y(centroid), 33.0);
     satc_point_destroy(centroid);
@@ -105,7 +165,7 @@ void satc_polygon_get_centroid_test () {
     points[1] = b;
     points[2] = c;
     satc_polygon_t *polygon = satc_polygon_create(pos, 3, points);
-    double *centroid = satc_polygon_get_centroid(polygon);
+    SATC_REAL *centroid = satc_polygon_get_centroid(polygon);
     assert(isfinite(satc_point_get_x(centroid)));
     assert(isfinite(satc_point_get_y(centroid)));
     satc_assert_near(satc_point_get_x(centroid), 1.0);
@@ -119,7 +179,7 @@ void satc_polygon_get_centroid_test () {
     satc_point_alloca_xy(pos, 7.0, 8.0);
     satc_point_array_alloca(points, 0);
     satc_polygon_t *polygon = satc_polygon_create(pos, 0, points);
-    double *centroid = satc_polygon_get_centroid(polygon);
+    SATC_REAL *centroid = satc_polygon_get_centroid(polygon);
     satc_assert_near(satc_point_get_x(centroid), 7.0);
     satc_assert_near(satc_point_get_y(centroid), 8.0);
     satc_point_destroy(centroid);
@@ -348,6 +408,31 @@ void satc_collision_test () {
     satc_box_destroy(box_1);
   }
 
+  {
+    // Polygon-to-polygon overlap along an axis where A's range ends inside
+    // B's. Two right triangles overlap least along their hypotenuses.
+    satc_point_alloca_xy(pos_1, 0.0, 0.0);
+    satc_point_alloca_xy(pos_2, 3.0, 3.0);
+    satc_point_alloca_xy(corner, 0.0, 0.0);
+    satc_point_alloca_xy(right, 10.0, 0.0);
+    satc_point_alloca_xy(top, 0.0, 10.0);
+    satc_point_array_alloca(points, 3);
+    points[0] = corner;
+    points[1] = right;
+    points[2] = top;
+    satc_polygon_t *polygon_1 = satc_polygon_create(pos_1, 3, points);
+    satc_polygon_t *polygon_2 = satc_polygon_create(pos_2, 3, points);
+    satc_response_t *response = satc_response_create();
+    bool collided = satc_test_polygon_polygon(polygon_1, polygon_2, response);
+    assert(collided);
+    satc_assert_near(response->overlap, 2.0 * sqrt(2.0));
+    satc_assert_near(satc_point_get_x(response->overlap_v), 2.0);
+    satc_assert_near(satc_point_get_y(response->overlap_v), 2.0);
+    satc_response_destroy(response);
+    satc_polygon_destroy(polygon_2);
+    satc_polygon_destroy(polygon_1);
+  }
+
   {
     // Polygon-to-polygon containment flags.
     satc_point_alloca_xy(pos_1, 20.0, 20.0);
@@ -514,6 +599,59 @@ void satc_point_test () {
   }
 }
 
+bool satc_point_in_polygon_reference (SATC_REAL *point, satc_polygon_t *polygon) {
+  // Tests a point the way `satc_point_in_polygon` used to, with a tiny box.
+  if (polygon->num_calc_points == 0) return false;
+  satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 0.000001, 0.000001 };
+  satc_point_copy(box.pos, point);
+  satc_polygon_t *test_point = satc_box_to_polygon(&box);
+  satc_response_t response = SATC_RESPONSE_INIT;
+  bool result = satc_test_polygon_polygon(test_point, polygon, &response) && response.a_in_b;
+  satc_polygon_destroy(test_point);
+  return result;
+}
+
+void satc_point_in_polygon_matches_reference_test () {
+  satc_point_alloca_xy(pos, 3.0, -2.0);
+  satc_point_array_alloca(points, 5);
+  satc_point_alloca_xy(a, -10.0, -10.0);
+  satc_point_alloca_xy(b, 10.0, -12.0);
+  satc_point_alloca_xy(c, 14.0, 4.0);
+  satc_point_alloca_xy(d, 0.0, 12.0);
+  satc_point_alloca_xy(e, -12.0, 3.0);
+  points[0] = a;
+  points[1] = b;
+  points[2] = c;
+  points[3] = d;
+  points[4] = e;
+  satc_polygon_t *polygon = satc_polygon_create(pos, 5, points);
+
+  // The opposite winding order.
+  satc_point_array_alloca(reversed_points, 5);
+  size_t i = 0;
+  for (; i < 5; i++) reversed_points[i] = points[4 - i];
+  satc_polygon_t *reversed = satc_polygon_create(pos, 5, reversed_points);
+
+  SATC_REAL angle = 0.0;
+  for (; angle < 6.0; angle += 1.3) {
+    satc_polygon_set_angle(polygon, angle);
+    satc_polygon_set_angle(reversed, angle);
+    SATC_REAL x = -20.13;
+    for (; x < 20.0; x += 1.7) {
+      SATC_REAL y = -20.07;
+      for (; y < 20.0; y += 1.9) {
+        satc_point_alloca_xy(point, x, y);
+        bool expected = satc_point_in_polygon_reference(point, polygon);
+        assert(satc_point_in_polygon(point, polygon) == expected);
+        assert(satc_point_in_polygon(point, reversed) == expected);
+      }
+    }
+  }
+
+  satc_polygon_destroy(reversed);
+  satc_polygon_destroy(polygon);
+}
+
 void satc_polygon_transform_test () {
   {
     // Polygon translation adds a delta to every point.
@@ -527,12 +665,45 @@ void satc_polygon_transform_test () {
     points[2] = c;
     satc_polygon_t *polygon = satc_polygon_create(pos, 3, points);
     satc_polygon_translate(polygon, 10.0, 20.0);
-    satc_assert_near(satc_point_get_x(polygon->points[0]), 11.0);
-    satc_assert_near(satc_point_get_y(polygon->points[0]), 22.0);
-    satc_assert_near(satc_point_get_x(polygon->points[1]), 13.0);
-    satc_assert_near(satc_point_get_y(polygon->points[1]), 24.0);
-    satc_assert_near(satc_point_get_x(polygon->points[2]), 15.0);
-    satc_assert_near(satc_point_get_y(polygon->points[2]), 26.0);
+    satc_assert_near(polygon->points.x[0], 11.0);
+    satc_assert_near(polygon->points.y[0], 22.0);
+    satc_assert_near(polygon->points.x[1], 13.0);
+    satc_assert_near(polygon->points.y[1], 24.0);
+    satc_assert_near(polygon->points.x[2], 15.0);
+    satc_assert_near(polygon->points.y[2], 26.0);
+    satc_polygon_destroy(polygon);
+  }
+
+  {
+    // Replacing points reuses the polygon's storage when it is large enough.
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_point_array_alloca(points, 4);
+    satc_point_alloca_xy(a, 0.0, 0.0);
+    satc_point_alloca_xy(b, 10.0, 0.0);
+    satc_point_alloca_xy(c, 10.0, 10.0);
+    satc_point_alloca_xy(d, 0.0, 10.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    points[3] = d;
+    satc_polygon_t *polygon = satc_polygon_create(pos, 4, points);
+    SATC_REAL *storage = polygon->storage;
+    assert(polygon->capacity == 4);
+
+    satc_polygon_set_points(polygon, 3, points);
+    assert(polygon->storage == storage);
+    assert(polygon->capacity == 4);
+    assert(polygon->num_points == 3);
+    assert(polygon->num_normals == 3);
+    satc_polygon_update(polygon);
+    satc_assert_near(polygon->edges.x[2], 0.0 - 10.0);
+    satc_assert_near(polygon->edges.y[2], 0.0 - 10.0);
+
+    satc_polygon_set_points(polygon, 4, points);
+    assert(polygon->storage == storage);
+    satc_polygon_update(polygon);
+    satc_assert_near(polygon->normals.x[1], 1.0);
+    satc_assert_near(polygon->normals.y[1], 0.0);
     satc_polygon_destroy(polygon);
   }
 
@@ -559,8 +730,8 @@ void satc_polygon_transform_test () {
     satc_response_t *response = satc_response_create();
     bool collided = satc_test_polygon_polygon(polygon_1, polygon_2, response);
     assert(!collided);
-    satc_assert_near(satc_point_get_x(polygon_1->calc_points[0]), 21.0);
-    satc_assert_near(satc_point_get_y(polygon_1->calc_points[0]), -10.0);
+    satc_assert_near(polygon_1->calc_points.x[0], 21.0);
+    satc_assert_near(polygon_1->calc_points.y[0], -10.0);
 
     satc_response_destroy(response);
     satc_polygon_destroy(polygon_2);
@@ -568,6 +739,51 @@ void satc_polygon_transform_test () {
     satc_polygon_destroy(polygon_1);
   }
 
+  {
+    // Calculated values are recalculated lazily, and translations leave the
+    // edges and normals alone.
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_point_array_alloca(points, 3);
+    satc_point_alloca_xy(a, 0.0, 0.0);
+    satc_point_alloca_xy(b, 10.0, 0.0);
+    satc_point_alloca_xy(c, 0.0, 10.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    satc_polygon_t *polygon = satc_polygon_create(pos, 3, points);
+    assert(polygon->dirty == (SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES | SATC_POLYGON_DIRTY_LOCAL_NORMALS));
+    satc_polygon_update(polygon);
+    assert(satc_world_dirty(polygon) == 0);
+
+    // Poison the edges; a translation must not recalculate them.
+    polygon->edges.x[0] = 123.0;
+    satc_polygon_translate(polygon, 5.0, 5.0);
+    assert(satc_world_dirty(polygon) == SATC_POLYGON_DIRTY_CALC_POINTS);
+    satc_point_alloca_xy(offset, 1.0, 0.0);
+    satc_polygon_set_offset(polygon, offset);
+    assert(satc_world_dirty(polygon) == SATC_POLYGON_DIRTY_CALC_POINTS);
+    satc_assert_near(polygon->calc_points.x[0], 0.0);
+    satc_polygon_update(polygon);
+    assert(satc_world_dirty(polygon) == 0);
+    satc_assert_near(polygon->calc_points.x[0], 6.0);
+    satc_assert_near(polygon->calc_points.y[0], 5.0);
+    satc_assert_near(polygon->edges.x[0], 123.0);
+
+    // Setting the same angle does nothing, while a new angle marks everything.
+    satc_polygon_set_angle(polygon, 0.0);
+    assert(satc_world_dirty(polygon) == 0);
+    satc_polygon_set_angle(polygon, M_PI / 2.0);
+    assert(satc_world_dirty(polygon) == (SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES));
+
+    // Readers update the polygon for you.
+    satc_aabb_t bounds;
+    satc_polygon_get_bounds(polygon, &bounds);
+    assert(satc_world_dirty(polygon) == 0);
+    satc_assert_near(polygon->edges.x[0], 0.0);
+    satc_assert_near(polygon->edges.y[0], 10.0);
+    satc_polygon_destroy(polygon);
+  }
+
   {
     // AABB uses deterministic minima for its origin.
     satc_point_alloca_xy(pos, 0.0, 0.0);
@@ -594,8 +810,8 @@ void satc_polygon_transform_test () {
     satc_polygon_t *aabb = satc_polygon_get_aabb(polygon);
     satc_assert_near(satc_point_get_x(aabb->pos), 7.0);
     satc_assert_near(satc_point_get_y(aabb->pos), 8.0);
-    satc_assert_near(satc_point_get_x(aabb->points[2]), 0.0);
-    satc_assert_near(satc_point_get_y(aabb->points[2]), 0.0);
+    satc_assert_near(aabb->points.x[2], 0.0);
+    satc_assert_near(aabb->points.y[2], 0.0);
     satc_polygon_destroy(aabb);
     satc_polygon_destroy(polygon);
   }
@@ -616,15 +832,16 @@ void satc_polygon_transform_test () {
     satc_point_alloca_xy(offset, 3.0, -4.0);
     satc_polygon_set_offset(polygon, offset);
     satc_polygon_set_angle(polygon, M_PI / 4.0);
+    satc_polygon_update(polygon);
 
-    double x_min = satc_point_get_x(polygon->calc_points[0]) + satc_point_get_x(polygon->pos);
-    double y_min = satc_point_get_y(polygon->calc_points[0]) + satc_point_get_y(polygon->pos);
-    double x_max = x_min;
-    double y_max = y_min;
+    SATC_REAL x_min = polygon->calc_points.x[0] + satc_point_get_x(polygon->pos);
+    SATC_REAL y_min = polygon->calc_points.y[0] + satc_point_get_y(polygon->pos);
+    SATC_REAL x_max = x_min;
+    SATC_REAL y_max = y_min;
     size_t i = 1;
     for (; i < polygon->num_calc_points; i++) {
-      double x = satc_point_get_x(polygon->calc_points[i]) + satc_point_get_x(polygon->pos);
-      double y = satc_point_get_y(polygon->calc_points[i]) + satc_point_get_y(polygon->pos);
+      SATC_REAL x = polygon->calc_points.x[i] + satc_point_get_x(polygon->pos);
+      SATC_REAL y = polygon->calc_points.y[i] + satc_point_get_y(polygon->pos);
       if (x < x_min) x_min = x;
       if (x > x_max) x_max = x;
       if (y < y_min) y_min = y;
@@ -634,8 +851,15 @@ void satc_polygon_transform_test () {
     satc_polygon_t *aabb = satc_polygon_get_aabb(polygon);
     satc_assert_near(satc_point_get_x(aabb->pos), x_min);
     satc_assert_near(satc_point_get_y(aabb->pos), y_min);
-    satc_assert_near(satc_point_get_x(aabb->points[2]), x_max - x_min);
-    satc_assert_near(satc_point_get_y(aabb->points[2]), y_max - y_min);
+    satc_assert_near(aabb->points.x[2], x_max - x_min);
+    satc_assert_near(aabb->points.y[2], y_max - y_min);
+
+    satc_aabb_t bounds;
+    satc_polygon_get_bounds(polygon, &bounds);
+    satc_assert_near(satc_point_get_x(bounds.min), x_min);
+    satc_assert_near(satc_point_get_y(bounds.min), y_min);
+    satc_assert_near(satc_point_get_x(bounds.max), x_max);
+    satc_assert_near(satc_point_get_y(bounds.max), y_max);
 
     satc_polygon_destroy(aabb);
     satc_polygon_destroy(polygon);
@@ -722,11 +946,1964 @@ void satc_polygon_transform_test () {
   }
 }
 
+void satc_polygon_update_batch_test () {
+  {
+    // Batch updates match recalculating every vertex by hand, including the
+    // leftover vertices past the last full SIMD register and a zero-length
+    // edge.
+    size_t num_points = 11;
+    satc_point_array_alloca(points, 11);
+    SATC_REAL coords[11][2];
+    size_t i = 0;
+    for (; i < num_points; i++) {
+      SATC_REAL theta = (2.0 * M_PI * i) / (num_points - 1);
+      satc_point_set_xy(coords[i], 10.0 * cos(theta), 5.0 * sin(theta));
+      points[i] = coords[i];
+    }
+    // The last point repeats the first, so the last edge has zero length.
+    points[num_points - 1] = points[0];
+
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_polygon_t *polygons[3];
+    size_t j = 0;
+    for (; j < 3; j++) polygons[j] = satc_polygon_create(pos, num_points, points);
+
+    SATC_REAL angles[3] = { 0.0, M_PI / 5.0, -2.0 };
+    SATC_REAL offsets_x[3] = { 1.0, -3.0, 0.5 };
+    SATC_REAL offsets_y[3] = { 2.0, 7.0, 0.0 };
+    satc_points_t offsets;
+    offsets.x = offsets_x;
+    offsets.y = offsets_y;
+    satc_polygon_update_batch(3, polygons, angles, &offsets);
+
+    for (j = 0; j < 3; j++) {
+      satc_polygon_t *polygon = polygons[j];
+      assert(satc_world_dirty(polygon) == 0);
+      satc_vec2_t offset = satc_vec2(offsets_x[j], offsets_y[j]);
+      SATC_REAL x_min = SATC_REAL_MAX;
+      SATC_REAL x_max = -SATC_REAL_MAX;
+      for (i = 0; i < num_points; i++) {
+        satc_vec2_t expected = satc_vec2_rotate(satc_vec2_add(satc_vec2_load(points[i]), offset), angles[j]);
+        satc_assert_near(polygon->calc_points.x[i], expected.x);
+        satc_assert_near(polygon->calc_points.y[i], expected.y);
+        if (expected.x < x_min) x_min = expected.x;
+        if (expected.x > x_max) x_max = expected.x;
+      }
+      satc_assert_near(satc_point_get_x(polygon->aabb.min), x_min);
+      satc_assert_near(satc_point_get_x(polygon->aabb.max), x_max);
+      for (i = 0; i < num_points; i++) {
+        size_t next = (i + 1) % num_points;
+        satc_vec2_t edge = satc_vec2(polygon->calc_points.x[next] - polygon->calc_points.x[i], polygon->calc_points.y[next] - polygon->calc_points.y[i]);
+        satc_vec2_t normal = satc_vec2_normalize(satc_vec2_perp(edge));
+        satc_assert_near(polygon->edges.x[i], edge.x);
+        satc_assert_near(polygon->edges.y[i], edge.y);
+        satc_assert_near(polygon->normals.x[i], normal.x);
+        satc_assert_near(polygon->normals.y[i], normal.y);
+      }
+      satc_assert_near(polygon->normals.x[num_points - 1], 0.0);
+      satc_assert_near(polygon->normals.y[num_points - 1], 0.0);
+    }
+
+    // Leaving the angles alone only moves the points.
+    polygons[1]->edges.x[0] = 123.0;
+    satc_polygon_update_batch(3, polygons, NULL, &offsets);
+    satc_assert_near(polygons[1]->edges.x[0], 123.0);
+
+    for (j = 0; j < 3; j++) satc_polygon_destroy(polygons[j]);
+  }
+
+  {
+    // Polygons following a transform keep its angle, whatever the batch says.
+    satc_point_array_alloca(points, 3);
+    satc_point_alloca_xy(a, 0.0, 0.0);
+    satc_point_alloca_xy(b, 10.0, 0.0);
+    satc_point_alloca_xy(c, 0.0, 5.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_transform_t transform = SATC_TRANSFORM_INIT;
+    satc_polygon_t *polygons[2];
+    polygons[0] = satc_polygon_set_transform(satc_polygon_create(pos, 3, points), &transform);
+    polygons[1] = satc_polygon_create(pos, 3, points);
+    SATC_REAL angles[2] = { 1.5, 1.5 };
+    satc_polygon_update_batch(2, polygons, angles, NULL);
+    assert(polygons[0]->angle == 0.0);
+    assert(transform.angle == 0.0);
+    satc_assert_near(polygons[0]->calc_points.x[1], 10.0);
+    satc_assert_near(polygons[0]->calc_points.y[1], 0.0);
+    assert(polygons[1]->angle == 1.5);
+    satc_assert_near(polygons[1]->calc_points.x[1], 10.0 * SATC_COS(1.5));
+    satc_assert_near(polygons[1]->calc_points.y[1], 10.0 * SATC_SIN(1.5));
+
+    // Turning the transform still turns the polygon.
+    satc_transform_set_angle(&transform, 0.5);
+    satc_polygon_update_batch(2, polygons, angles, NULL);
+    assert(polygons[0]->angle == 0.5);
+    satc_assert_near(polygons[0]->calc_points.x[1], 10.0 * SATC_COS(0.5));
+    satc_assert_near(polygons[0]->calc_points.y[1], 10.0 * SATC_SIN(0.5));
+
+    satc_polygon_destroy(polygons[1]);
+    satc_polygon_destroy(polygons[0]);
+  }
+
+  {
+    // An edge within rounding of zero length has no normal either.
+    satc_point_array_alloca(points, 5);
+    satc_point_alloca_xy(a, 0.0, 0.0);
+    satc_point_alloca_xy(b, 10.0, 0.0);
+    satc_point_alloca_xy(c, 10.0, 10.0);
+    satc_point_alloca_xy(d, 0.0, 10.0);
+    satc_point_alloca_xy(e, 0.0, 10.0 * SATC_REAL_EPSILON);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    points[3] = d;
+    points[4] = e;
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_polygon_t *polygon = satc_polygon_create(pos, 5, points);
+    satc_polygon_set_angle(polygon, 0.3);
+    satc_polygon_update(polygon);
+    assert(polygon->normals.x[4] == 0.0 && polygon->normals.y[4] == 0.0);
+    satc_assert_near(polygon->normals.x[3], -SATC_COS(0.3));
+    satc_assert_near(polygon->normals.y[3], -SATC_SIN(0.3));
+    satc_polygon_destroy(polygon);
+  }
+}
+
+void satc_test_polygon_polygon_local_test () {
+  {
+    // The local-space narrowphase agrees with the world-space one.
+    satc_point_array_alloca(points_1, 5);
+    satc_point_alloca_xy(a_1, 0.0, -8.0);
+    satc_point_alloca_xy(b_1, 9.0, -2.0);
+    satc_point_alloca_xy(c_1, 5.0, 7.0);
+    satc_point_alloca_xy(d_1, -5.0, 7.0);
+    satc_point_alloca_xy(e_1, -9.0, -2.0);
+    points_1[0] = a_1;
+    points_1[1] = b_1;
+    points_1[2] = c_1;
+    points_1[3] = d_1;
+    points_1[4] = e_1;
+    satc_point_array_alloca(points_2, 4);
+    satc_point_alloca_xy(a_2, -12.0, -3.0);
+    satc_point_alloca_xy(b_2, 12.0, -3.0);
+    satc_point_alloca_xy(c_2, 12.0, 3.0);
+    satc_point_alloca_xy(d_2, -12.0, 3.0);
+    points_2[0] = a_2;
+    points_2[1] = b_2;
+    points_2[2] = c_2;
+    points_2[3] = d_2;
+
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_polygon_t *polygon_1 = satc_polygon_create(pos, 5, points_1);
+    satc_polygon_t *polygon_2 = satc_polygon_create(pos, 4, points_2);
+    satc_point_alloca_xy(offset, 1.5, -2.5);
+    satc_polygon_set_offset(polygon_2, offset);
+
+    satc_response_t world = SATC_RESPONSE_INIT;
+    satc_response_t local = SATC_RESPONSE_INIT;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t i = 0;
+    for (; i < 40; i++) {
+      satc_point_set_xy(polygon_1->pos, 3.3 * (i % 7), -1.7 * (i % 5));
+      satc_polygon_set_angle(polygon_1, 0.37 * i);
+      satc_point_set_xy(polygon_2->pos, 14.1 - 2.9 * (i % 9), 6.3 - 1.9 * (i % 6));
+      satc_polygon_set_angle(polygon_2, (i % 4 == 0) ? 0.0 : -0.61 * i);
+
+      // Testing locally leaves the calculated points alone.
+      bool collided_local = satc_test_polygon_polygon_local(polygon_1, polygon_2, &local);
+      assert(polygon_1->dirty & SATC_POLYGON_DIRTY_CALC_POINTS);
+      bool collided_world = satc_test_polygon_polygon(polygon_1, polygon_2, &world);
+      assert(collided_local == collided_world);
+      if (!collided_world) {
+        misses++;
+        continue;
+      }
+      hits++;
+      assert(local.a == polygon_1 && local.b == polygon_2);
+      satc_assert_near(local.overlap, world.overlap);
+      satc_assert_near(satc_point_get_x(local.overlap_n), satc_point_get_x(world.overlap_n));
+      satc_assert_near(satc_point_get_y(local.overlap_n), satc_point_get_y(world.overlap_n));
+      satc_assert_near(satc_point_get_x(local.overlap_v), satc_point_get_x(world.overlap_v));
+      satc_assert_near(satc_point_get_y(local.overlap_v), satc_point_get_y(world.overlap_v));
+      assert(local.a_in_b == world.a_in_b);
+      assert(local.b_in_a == world.b_in_a);
+    }
+    assert(hits > 0);
+    assert(misses > 0);
+
+    satc_polygon_destroy(polygon_2);
+    satc_polygon_destroy(polygon_1);
+  }
+}
+
+void satc_geometry_test () {
+  {
+    // Instances share their geometry's points, and match polygons which own
+    // their points.
+    satc_point_array_alloca(points, 4);
+    satc_point_alloca_xy(a, -10.0, -5.0);
+    satc_point_alloca_xy(b, 10.0, -5.0);
+    satc_point_alloca_xy(c, 10.0, 5.0);
+    satc_point_alloca_xy(d, -10.0, 5.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    points[3] = d;
+    satc_geometry_t *geometry = satc_geometry_create(4, points);
+    assert(geometry->refs == 1);
+    satc_assert_near(geometry->normals.x[1], 1.0);
+    satc_assert_near(geometry->normals.y[1], 0.0);
+
+    satc_point_alloca_xy(pos_1, 0.0, 0.0);
+    satc_point_alloca_xy(pos_2, 15.0, 3.0);
+    size_t allocs = satc_alloc_stats.allocs[SATC_ALLOC_POLYGON];
+    satc_polygon_t *instance_1 = satc_polygon_create_instance(pos_1, geometry);
+    satc_polygon_t *instance_2 = satc_polygon_create_instance(pos_2, geometry);
+    assert(geometry->refs == 3);
+    assert(instance_1->points.x == geometry->points.x);
+    assert(instance_1->storage == NULL);
+
+    // Testing locally never allocates the calculated values.
+    satc_polygon_set_angle(instance_2, M_PI / 7.0);
+    satc_response_t local = SATC_RESPONSE_INIT;
+    assert(satc_test_polygon_polygon_local(instance_1, instance_2, &local));
+    assert(instance_1->storage == NULL);
+    assert(instance_2->storage == NULL);
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_POLYGON] == allocs + 2);
+
+    satc_polygon_t *owned_1 = satc_polygon_create(pos_1, 4, points);
+    satc_polygon_t *owned_2 = satc_polygon_create(pos_2, 4, points);
+    satc_polygon_set_angle(owned_2, M_PI / 7.0);
+    satc_response_t shared = SATC_RESPONSE_INIT;
+    satc_response_t owned = SATC_RESPONSE_INIT;
+    assert(satc_test_polygon_polygon(instance_1, instance_2, &shared));
+    assert(satc_test_polygon_polygon(owned_1, owned_2, &owned));
+    satc_assert_near(shared.overlap, owned.overlap);
+    satc_assert_near(local.overlap, owned.overlap);
+    satc_assert_near(satc_point_get_x(shared.overlap_v), satc_point_get_x(owned.overlap_v));
+    satc_assert_near(satc_point_get_y(shared.overlap_v), satc_point_get_y(owned.overlap_v));
+    size_t i = 0;
+    for (; i < 4; i++) {
+      satc_assert_near(instance_2->calc_points.x[i], owned_2->calc_points.x[i]);
+      satc_assert_near(instance_2->edges.y[i], owned_2->edges.y[i]);
+      satc_assert_near(instance_2->normals.x[i], owned_2->normals.x[i]);
+      satc_assert_near(instance_2->normals.y[i], owned_2->normals.y[i]);
+    }
+
+    // Changing an instance's points copies them first.
+    satc_polygon_translate(instance_2, 1.0, 0.0);
+    assert(instance_2->geometry == NULL);
+    assert(geometry->refs == 2);
+    satc_assert_near(instance_2->points.x[0], -9.0);
+    satc_assert_near(geometry->points.x[0], -10.0);
+    satc_polygon_update(instance_2);
+    satc_assert_near(instance_2->calc_points.x[0], owned_2->calc_points.x[0] + cos(M_PI / 7.0));
+
+    satc_polygon_destroy(owned_2);
+    satc_polygon_destroy(owned_1);
+    satc_polygon_destroy(instance_2);
+    satc_polygon_destroy(instance_1);
+    assert(geometry->refs == 1);
+    satc_geometry_release(geometry);
+  }
+
+  {
+    // Geometry and its instances can be carved out of an arena.
+    unsigned char memory[2048];
+    satc_arena_t arena;
+    satc_arena_init(&arena, memory, sizeof(memory));
+    satc_point_array_alloca(points, 3);
+    satc_point_alloca_xy(a, 0.0, 0.0);
+    satc_point_alloca_xy(b, 4.0, 0.0);
+    satc_point_alloca_xy(c, 0.0, 4.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    satc_geometry_t *geometry = satc_geometry_create_in(&arena, 3, points);
+    satc_point_alloca_xy(pos, 1.0, 1.0);
+    satc_polygon_t *instance = satc_polygon_create_instance_in(&arena, pos, geometry);
+    satc_point_alloca_xy(inside, 2.0, 2.0);
+    assert(satc_point_in_polygon(inside, instance));
+    assert(instance->storage != NULL);
+    assert((unsigned char *) instance->storage >= memory && (unsigned char *) instance->storage < memory + sizeof(memory));
+    satc_arena_reset(&arena);
+  }
+}
+
+void satc_polygon_view_test () {
+  {
+    // Views read straight from interleaved or separate caller-owned buffers,
+    // and match polygons which own their points.
+    SATC_REAL vertices[] = {
+      -10.0, -5.0, 0.0, 0.0,
+      10.0, -5.0, 1.0, 0.0,
+      10.0, 5.0, 1.0, 1.0,
+      -10.0, 5.0, 0.0, 1.0,
+    };
+    SATC_REAL xs[] = { -10.0, 10.0, 10.0, -10.0 };
+    SATC_REAL ys[] = { -5.0, -5.0, 5.0, 5.0 };
+    satc_point_array_alloca(points, 4);
+    size_t i = 0;
+    for (; i < 4; i++) points[i] = vertices + i * 4;
+
+    satc_point_alloca_xy(pos, 3.0, 2.0);
+    satc_polygon_t *interleaved = satc_polygon_create_view(pos, 4, vertices, vertices + 1, 4);
+    satc_polygon_t *separate = satc_polygon_create_view(pos, 4, xs, ys, 1);
+    satc_polygon_t *owned = satc_polygon_create(pos, 4, points);
+    assert(interleaved->points.x == vertices);
+    satc_polygon_set_angle(interleaved, 0.4);
+    satc_polygon_set_angle(separate, 0.4);
+    satc_polygon_set_angle(owned, 0.4);
+    satc_polygon_update(interleaved);
+    satc_polygon_update(separate);
+    satc_polygon_update(owned);
+    for (i = 0; i < 4; i++) {
+      satc_assert_near(interleaved->calc_points.x[i], owned->calc_points.x[i]);
+      satc_assert_near(interleaved->calc_points.y[i], owned->calc_points.y[i]);
+      satc_assert_near(separate->normals.x[i], owned->normals.x[i]);
+      satc_assert_near(separate->normals.y[i], owned->normals.y[i]);
+    }
+
+    satc_point_alloca_xy(other_pos, 18.0, 2.0);
+    satc_polygon_t *other = satc_polygon_create(other_pos, 4, points);
+    satc_response_t world = SATC_RESPONSE_INIT;
+    satc_response_t local = SATC_RESPONSE_INIT;
+    assert(satc_test_polygon_polygon(interleaved, other, &world));
+    assert(satc_test_polygon_polygon_local(interleaved, other, &local));
+    satc_assert_near(local.overlap, world.overlap);
+
+    // Changes to the buffer are picked up once the view is invalidated.
+    for (i = 0; i < 4; i++) vertices[i * 4] -= 10.0;
+    satc_polygon_invalidate(interleaved);
+    assert(!satc_test_polygon_polygon(interleaved, other, &world));
+    assert(!satc_test_polygon_polygon_local(interleaved, other, &local));
+
+    // Changing a view's points copies them first, leaving the buffer alone.
+    satc_polygon_translate(separate, 1.0, 0.0);
+    assert(!separate->points_borrowed);
+    satc_assert_near(separate->points.x[0], -9.0);
+    satc_assert_near(xs[0], -10.0);
+
+    satc_polygon_destroy(other);
+    satc_polygon_destroy(owned);
+    satc_polygon_destroy(separate);
+    satc_polygon_destroy(interleaved);
+  }
+}
+
+void satc_small_polygon_test () {
+  {
+    // Small polygons live on the stack, and work with every test.
+    satc_point_array_alloca(points, 3);
+    satc_point_alloca_xy(a, 0.0, 0.0);
+    satc_point_alloca_xy(b, 10.0, 0.0);
+    satc_point_alloca_xy(c, 0.0, 10.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    size_t total = satc_alloc_stats_total();
+    satc_small_polygon_t triangle;
+    satc_polygon_t *polygon = satc_small_polygon_init(&triangle, pos, 3, points);
+    assert(polygon == &triangle.polygon);
+    assert(polygon->storage == triangle.storage);
+
+    satc_box_t box;
+    satc_point_alloca_xy(box_pos, 2.0, 2.0);
+    satc_point_copy(box.pos, box_pos);
+    box.type = satc_type_box;
+    box.w = 4.0;
+    box.h = 4.0;
+    satc_small_polygon_t box_polygon;
+    satc_box_to_small_polygon(&box, &box_polygon);
+
+    satc_response_t response = SATC_RESPONSE_INIT;
+    assert(satc_test_polygon_polygon(polygon, &box_polygon.polygon, &response));
+    assert(satc_test_polygon_polygon_local(polygon, &box_polygon.polygon, &response));
+    satc_point_alloca_xy(point, 1.0, 1.0);
+    assert(satc_point_in_polygon(point, polygon));
+    assert(satc_alloc_stats_total() == total);
+
+    // Growing past the capacity moves into allocated storage.
+    size_t num_many = SATC_SMALL_POLYGON_CAPACITY + 1;
+    satc_point_array_alloca(many, num_many);
+    size_t i = 0;
+    for (; i < num_many; i++) many[i] = (i % 2 == 0) ? a : b;
+    assert(satc_small_polygon_init(&triangle, pos, num_many, many) == NULL);
+    polygon = satc_small_polygon_init(&triangle, pos, 3, points);
+    satc_polygon_set_points(polygon, num_many, many);
+    assert(!polygon->storage_inline);
+    assert(polygon->capacity == num_many);
+
+    // Growing allocated storage replaces it with one new block.
+    size_t allocs = satc_alloc_stats.allocs[SATC_ALLOC_POLYGON];
+    size_t frees = satc_alloc_stats.frees[SATC_ALLOC_POLYGON];
+    size_t num_more = num_many + 1;
+    satc_point_array_alloca(more, num_more);
+    for (i = 0; i < num_more; i++) more[i] = points[i % 3];
+    satc_polygon_set_points(polygon, num_more, more);
+    assert(polygon->capacity == num_more);
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_POLYGON] == allocs + 1);
+    assert(satc_alloc_stats.frees[SATC_ALLOC_POLYGON] == frees + 1);
+    assert(satc_point_in_polygon(point, polygon));
+    satc_polygon_destroy(polygon);
+    satc_polygon_destroy(&box_polygon.polygon);
+    assert(satc_alloc_stats_total() == total + 2);
+  }
+
+  {
+    // Small polygons can be created as a single allocation.
+    satc_point_array_alloca(points, 3);
+    satc_point_alloca_xy(a, 0.0, 0.0);
+    satc_point_alloca_xy(b, 10.0, 0.0);
+    satc_point_alloca_xy(c, 0.0, 10.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    size_t allocs = satc_alloc_stats.allocs[SATC_ALLOC_POLYGON];
+    satc_polygon_t *polygon = satc_small_polygon_create(pos, 3, points);
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_POLYGON] == allocs + 1);
+    assert((SATC_REAL *) (polygon + 1) <= polygon->storage);
+    satc_polygon_t *owned = satc_polygon_create(pos, 3, points);
+    assert(satc_test_polygon_polygon(polygon, owned, NULL));
+    satc_polygon_destroy(owned);
+    satc_polygon_destroy(polygon);
+  }
+}
+
+// Test every normal of both polygons in turn, the way `satc_test_polygon_polygon` did before twins.
+bool satc_test_polygon_polygon_reference (satc_polygon_t *a, satc_polygon_t *b, satc_response_t *response) {
+  satc_polygon_update(a);
+  satc_polygon_update(b);
+  satc_response_clear(response);
+  satc_point_alloca(axis);
+  size_t i = 0;
+  for (; i < a->num_points + b->num_points; i++) {
+    satc_polygon_t *polygon = i < a->num_points ? a : b;
+    size_t j = i < a->num_points ? i : i - a->num_points;
+    satc_point_set_xy(axis, polygon->normals.x[j], polygon->normals.y[j]);
+    if (satc_is_separating_axis(a->pos, b->pos, a->num_points, &a->calc_points, b->num_points, &b->calc_points, axis, response)) {
+      return false;
+    }
+  }
+  satc_point_copy(response->overlap_v, response->overlap_n);
+  satc_point_scale_x(response->overlap_v, response->overlap);
+  return true;
+}
+
+void satc_normal_twins_test () {
+  {
+    // The opposite sides of a box are twins, so a box has two axes.
+    satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 10.0, 10.0 };
+    satc_polygon_t *a = satc_box_to_polygon(&box);
+    satc_polygon_update(a);
+    assert(a->num_axes == 2);
+    assert(a->normal_twins[0] == 2);
+    assert(a->normal_twins[1] == 3);
+    assert(a->normal_twins[2] == 0);
+    assert(a->normal_twins[3] == 1);
+
+    // Responses match testing all eight normals, including which of equal overlaps wins.
+    satc_box_t other = { satc_type_box, { 0.0, 0.0 }, 4.0, 6.0 };
+    SATC_REAL offsets[6][2] = { { 5.0, 5.0 }, { 3.0, 7.0 }, { -2.0, 2.0 }, { 2.0, 2.0 }, { 6.0, -3.0 }, { 3.0, 2.0 } };
+    size_t i = 0;
+    for (; i < 6; i++) {
+      satc_point_set_xy(other.pos, offsets[i][0], offsets[i][1]);
+      satc_polygon_t *b = satc_box_to_polygon(&other);
+      satc_response_t expected = SATC_RESPONSE_INIT;
+      satc_response_t response = SATC_RESPONSE_INIT;
+      assert(satc_test_polygon_polygon_reference(a, b, &expected));
+      assert(satc_test_polygon_polygon(a, b, &response));
+      assert(response.overlap == expected.overlap);
+      assert(response.overlap_n[0] == expected.overlap_n[0]);
+      assert(response.overlap_n[1] == expected.overlap_n[1]);
+      assert(response.a_in_b == expected.a_in_b);
+      assert(response.b_in_a == expected.b_in_a);
+      assert(satc_test_polygon_polygon_local(a, b, &response));
+      assert(response.overlap == expected.overlap);
+      assert(response.overlap_n[0] == expected.overlap_n[0]);
+      assert(response.overlap_n[1] == expected.overlap_n[1]);
+      satc_polygon_destroy(b);
+    }
+
+    satc_point_set_xy(other.pos, 20.0, 0.0);
+    satc_polygon_t *b = satc_box_to_polygon(&other);
+    assert(!satc_test_polygon_polygon(a, b, NULL));
+    assert(!satc_test_polygon_polygon_local(a, b, NULL));
+    satc_polygon_destroy(b);
+    satc_polygon_destroy(a);
+  }
+
+  {
+    // Regular polygons with an even number of sides have twins, odd ones do not.
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_point_array_alloca(points, 6);
+    SATC_REAL coords[6][2];
+    size_t i = 0;
+    for (; i < 6; i++) points[i] = coords[i];
+    for (i = 0; i < 6; i++) {
+      satc_point_set_xy(points[i], 5.0 * SATC_COS(i * M_PI / 3.0), 5.0 * SATC_SIN(i * M_PI / 3.0));
+    }
+    satc_polygon_t *hexagon = satc_polygon_create(pos, 6, points);
+    for (i = 0; i < 3; i++) {
+      satc_point_set_xy(points[i], 5.0 * SATC_COS(i * 2.0 * M_PI / 3.0), 5.0 * SATC_SIN(i * 2.0 * M_PI / 3.0));
+    }
+    satc_polygon_t *triangle = satc_polygon_create(pos, 3, points);
+    satc_polygon_update(hexagon);
+    satc_polygon_update(triangle);
+    assert(hexagon->num_axes == 3);
+    assert(triangle->num_axes == 3);
+
+    // Rotation does not change the twins, and results still match up to rounding.
+    satc_polygon_set_angle(hexagon, 0.3);
+    satc_point_set_xy(triangle->pos, 4.0, 1.0);
+    satc_response_t expected = SATC_RESPONSE_INIT;
+    satc_response_t response = SATC_RESPONSE_INIT;
+    assert(satc_test_polygon_polygon_reference(hexagon, triangle, &expected));
+    assert(satc_test_polygon_polygon(hexagon, triangle, &response));
+    assert(hexagon->num_axes == 3);
+    satc_assert_near(response.overlap, expected.overlap);
+    satc_assert_near(response.overlap_n[0], expected.overlap_n[0]);
+    satc_assert_near(response.overlap_n[1], expected.overlap_n[1]);
+
+    // Instances share the twins of their geometry.
+    for (i = 0; i < 6; i++) {
+      satc_point_set_xy(points[i], 5.0 * SATC_COS(i * M_PI / 3.0), 5.0 * SATC_SIN(i * M_PI / 3.0));
+    }
+    satc_geometry_t *geometry = satc_geometry_create(6, points);
+    assert(geometry->num_axes == 3);
+    satc_polygon_t *instance = satc_polygon_create_instance(pos, geometry);
+    assert(instance->num_axes == 3);
+    assert(instance->normal_twins == geometry->normal_twins);
+    satc_polygon_destroy(instance);
+    satc_geometry_release(geometry);
+
+    // Replacing the points finds the twins again.
+    satc_polygon_set_points(hexagon, 3, points);
+    satc_polygon_update(hexagon);
+    assert(hexagon->num_axes == 3);
+    assert(hexagon->normal_twins[0] == 0);
+
+    satc_polygon_destroy(triangle);
+    satc_polygon_destroy(hexagon);
+  }
+}
+
+void satc_normal_extents_test () {
+  satc_point_alloca_xy(pos, 0.0, 0.0);
+  satc_point_array_alloca(points, 12);
+  SATC_REAL coords[12][2];
+  size_t i = 0;
+  for (; i < 12; i++) points[i] = coords[i];
+  satc_real_array_alloca(range, 2);
+  satc_point_alloca(normal);
+
+  {
+    // A convex polygon with uneven sides (on an ellipse) finds the far end of each range by walking.
+    SATC_REAL angles[12] = { 0.0, 0.4, 0.9, 1.1, 1.9, 2.3, 3.1, 3.3, 4.0, 4.8, 5.5, 6.0 };
+    for (i = 0; i < 12; i++) {
+      satc_point_set_xy(points[i], 9.0 * SATC_COS(angles[i]), 6.0 * SATC_SIN(angles[i]));
+    }
+    satc_polygon_t *polygon = satc_polygon_create(pos, 12, points);
+    satc_polygon_update(polygon);
+    assert(polygon->convex);
+    for (i = 0; i < 12; i++) {
+      satc_point_set_xy(normal, polygon->local_normals.x[i], polygon->local_normals.y[i]);
+      satc_flatten_points_on(12, &polygon->points, normal, range);
+      satc_assert_near(polygon->normal_extents.x[i], range[0]);
+      satc_assert_near(polygon->normal_extents.y[i], range[1]);
+    }
+
+    // Rotation and offsets do not change the extents, and results match projecting both polygons.
+    satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 6.0, 3.0 };
+    satc_polygon_t *other = satc_box_to_polygon(&box);
+    satc_point_alloca_xy(offset, 1.5, -0.5);
+    satc_polygon_set_offset(polygon, offset);
+    satc_polygon_set_angle(other, 0.7);
+    SATC_REAL angle = 0.0;
+    for (; angle < 6.0; angle += 0.9) {
+      satc_polygon_set_angle(polygon, angle);
+      SATC_REAL x = -16.0;
+      for (; x < 16.0; x += 2.3) {
+        satc_point_set_xy(other->pos, x, 0.3 * x);
+        satc_response_t expected = SATC_RESPONSE_INIT;
+        satc_response_t response = SATC_RESPONSE_INIT;
+        bool collided = satc_test_polygon_polygon_reference(polygon, other, &expected);
+        assert(satc_test_polygon_polygon(polygon, other, &response) == collided);
+        if (!collided) continue;
+        satc_assert_near(response.overlap, expected.overlap);
+        satc_assert_near(response.overlap_n[0], expected.overlap_n[0]);
+        satc_assert_near(response.overlap_n[1], expected.overlap_n[1]);
+        assert(response.a_in_b == expected.a_in_b);
+        assert(response.b_in_a == expected.b_in_a);
+      }
+    }
+    satc_polygon_destroy(other);
+    satc_polygon_destroy(polygon);
+  }
+
+  {
+    // Concave polygons and stars project every point instead.
+    satc_point_set_xy(points[0], 0.0, 0.0);
+    satc_point_set_xy(points[1], 10.0, 0.0);
+    satc_point_set_xy(points[2], 10.0, 10.0);
+    satc_point_set_xy(points[3], 5.0, 2.0);
+    satc_point_set_xy(points[4], 0.0, 10.0);
+    satc_polygon_t *polygon = satc_polygon_create(pos, 5, points);
+    satc_polygon_update(polygon);
+    assert(!polygon->convex);
+    for (i = 0; i < 5; i++) {
+      satc_point_set_xy(normal, polygon->local_normals.x[i], polygon->local_normals.y[i]);
+      satc_flatten_points_on(5, &polygon->points, normal, range);
+      assert(polygon->normal_extents.x[i] == range[0]);
+      assert(polygon->normal_extents.y[i] == range[1]);
+    }
+    for (i = 0; i < 5; i++) {
+      satc_point_set_xy(points[i], 10.0 * SATC_COS(i * 4.0 * M_PI / 5.0), 10.0 * SATC_SIN(i * 4.0 * M_PI / 5.0));
+    }
+    satc_polygon_set_points(polygon, 5, points);
+    satc_polygon_update(polygon);
+    assert(!polygon->convex);
+    satc_polygon_destroy(polygon);
+  }
+
+  {
+    // A repeated point at the inner corner of an L does not hide the corner,
+    // and an edge which turns straight back is not convex either.
+    SATC_REAL l_shape[7][2] = { { 0.0, 0.0 }, { 10.0, 0.0 }, { 10.0, 4.0 }, { 4.0, 4.0 }, { 4.0, 4.0 }, { 4.0, 10.0 }, { 0.0, 10.0 } };
+    SATC_REAL backtrack[5][2] = { { 4.0, 2.0 }, { 4.0, 4.0 }, { 4.0, 1.0 }, { 5.0, 2.0 }, { 3.0, 2.0 } };
+    satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 0.1, 0.3 };
+    satc_polygon_t *other = satc_box_to_polygon(&box);
+    size_t shape = 0;
+    for (; shape < 2; shape++) {
+      size_t num_points = shape == 0 ? 7 : 5;
+      SATC_REAL (*shape_coords)[2] = shape == 0 ? l_shape : backtrack;
+      for (i = 0; i < num_points; i++) {
+        satc_point_set_xy(points[i], shape_coords[i][0], shape_coords[i][1]);
+      }
+      satc_polygon_t *polygon = satc_polygon_create(pos, num_points, points);
+      satc_polygon_update(polygon);
+      assert(!polygon->convex);
+      for (i = 0; i < num_points; i++) {
+        satc_point_set_xy(normal, polygon->local_normals.x[i], polygon->local_normals.y[i]);
+        satc_flatten_points_on(num_points, &polygon->points, normal, range);
+        assert(polygon->normal_extents.x[i] == range[0]);
+        assert(polygon->normal_extents.y[i] == range[1]);
+      }
+      // Both tests agree with projecting every point.
+      SATC_REAL x = -1.0;
+      for (; x < 11.0; x += 0.35) {
+        SATC_REAL y = -1.0;
+        for (; y < 11.0; y += 0.35) {
+          satc_point_set_xy(other->pos, x, y);
+          satc_response_t expected = SATC_RESPONSE_INIT;
+          bool collided = satc_test_polygon_polygon_reference(polygon, other, &expected);
+          assert(satc_test_polygon_polygon(polygon, other, NULL) == collided);
+          assert(satc_test_polygon_polygon_local(polygon, other, NULL) == collided);
+        }
+      }
+      satc_polygon_destroy(polygon);
+    }
+    satc_polygon_destroy(other);
+  }
+}
+
+void satc_assert_responses_near (satc_response_t *response, satc_response_t *expected) {
+  assert(response->a == expected->a);
+  assert(response->b == expected->b);
+  satc_assert_near(response->overlap, expected->overlap);
+  satc_assert_near(response->overlap_n[0], expected->overlap_n[0]);
+  satc_assert_near(response->overlap_n[1], expected->overlap_n[1]);
+  satc_assert_near(response->overlap_v[0], expected->overlap_v[0]);
+  satc_assert_near(response->overlap_v[1], expected->overlap_v[1]);
+  assert(response->a_in_b == expected->a_in_b);
+  assert(response->b_in_a == expected->b_in_a);
+}
+
+// Tests the normals of a polygon one axis at a time, as
+// `_satc_is_separating_normals` does without `SATC_SIMD_AXES`.
+bool satc_is_separating_normals_reference (satc_polygon_t *polygon, satc_polygon_t *other, satc_vec2_t offset, bool polygon_is_a, size_t first_place, size_t *best_place, satc_response_t *response) {
+  SATC_REAL own_range[2];
+  SATC_REAL other_range[2];
+  SATC_REAL axis[2];
+  size_t i = 0;
+  for (; i < polygon->num_calc_points; i++) {
+    size_t twin = polygon->normal_twins[i];
+    if (twin < i) continue;
+    _satc_project_on_normal(polygon, other, offset, i, axis, own_range, other_range);
+    bool separated;
+    if (polygon_is_a) {
+      separated = _satc_is_separating_twin_range(own_range, other_range, axis, first_place + i, first_place + twin, best_place, response);
+    } else {
+      separated = _satc_is_separating_twin_range(other_range, own_range, axis, first_place + i, first_place + twin, best_place, response);
+    }
+    if (separated) {
+      *best_place = first_place + i;
+      return true;
+    }
+  }
+  return false;
+}
+
+void satc_axis_batch_test () {
+  // A 13-gon has thirteen axes and a 14-gon has seven, each shared by twin
+  // normals. Neither fills its last batch of axes.
+  satc_point_alloca_xy(pos, 0.0, 0.0);
+  satc_point_array_alloca(points, 14);
+  SATC_REAL coords[14][2];
+  satc_polygon_t *polygons[2];
+  size_t i = 0;
+  size_t p = 0;
+  for (; i < 14; i++) points[i] = coords[i];
+  for (; p < 2; p++) {
+    size_t sides = 13 + p;
+    for (i = 0; i < sides; i++) {
+      satc_point_set_xy(points[i], 5.0 * SATC_COS(i * 2.0 * M_PI / sides), 5.0 * SATC_SIN(i * 2.0 * M_PI / sides));
+    }
+    polygons[p] = satc_polygon_create(pos, sides, points);
+    satc_polygon_update(polygons[p]);
+  }
+  assert(polygons[0]->num_axes == 13);
+  assert(polygons[1]->num_axes == 7);
+  assert(polygons[1]->normal_twins[9] == 2);
+
+  satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 1.0, 1.0 };
+  satc_polygon_t *others[2] = { satc_box_to_polygon(&box), NULL };
+  satc_polygon_update(others[0]);
+
+  // Batched and single axes agree on whether and where the polygons are
+  // separated, and on the response when they are not, with the box moved
+  // around each polygon and the polygons moved around each other.
+  for (p = 0; p < 2; p++) {
+    satc_polygon_t *polygon = polygons[p];
+    others[1] = polygons[1 - p];
+    // Which of the polygon's axes, in the order they are tested, were the
+    // first to separate it from the box.
+    bool separates[14] = { false };
+    size_t o = 0;
+    for (; o < 2; o++) {
+      satc_polygon_t *other = others[o];
+      SATC_REAL angle = 0.0;
+      for (; angle < 2.0 * M_PI; angle += 0.05) {
+        SATC_REAL distance = 0.0;
+        for (; distance < 12.0; distance += 0.25) {
+          satc_point_set_xy(other->pos, distance * SATC_COS(angle), distance * SATC_SIN(angle));
+          satc_vec2_t offset = satc_vec2_sub(satc_vec2_load(other->pos), satc_vec2_load(polygon->pos));
+          size_t side = 0;
+          for (; side < 2; side++) {
+            bool polygon_is_a = side == 0;
+            size_t first_place = polygon_is_a ? 0 : other->num_calc_points;
+            size_t best_place = SIZE_MAX;
+            size_t expected_place = SIZE_MAX;
+            satc_response_t response = SATC_RESPONSE_INIT;
+            satc_response_t expected = SATC_RESPONSE_INIT;
+            bool separated = _satc_is_separating_normals(polygon, other, offset, polygon_is_a, first_place, &best_place, &response);
+            assert(separated == satc_is_separating_normals_reference(polygon, other, offset, polygon_is_a, first_place, &expected_place, &expected));
+            assert(best_place == expected_place);
+            if (!separated) {
+              satc_assert_responses_near(&response, &expected);
+              continue;
+            }
+            if (o != 0) continue;
+            size_t order = 0;
+            for (i = 0; i < best_place - first_place; i++) {
+              if (polygon->normal_twins[i] >= i) order++;
+            }
+            separates[order] = true;
+          }
+        }
+      }
+    }
+    // Every axis separates first somewhere, so separations are found in the
+    // first, middle and last lanes of each batch.
+    for (i = 0; i < polygon->num_axes; i++) assert(separates[i]);
+  }
+
+  satc_polygon_destroy(others[0]);
+  satc_polygon_destroy(polygons[0]);
+  satc_polygon_destroy(polygons[1]);
+}
+
+bool satc_test_polygon_circle_reference (satc_polygon_t *polygon, satc_circle_t *circle, satc_response_t *response) {
+  satc_polygon_update(polygon);
+  satc_response_clear(response);
+  size_t len = polygon->num_calc_points;
+  SATC_REAL cx = circle->pos[0] - polygon->pos[0];
+  SATC_REAL cy = circle->pos[1] - polygon->pos[1];
+  SATC_REAL radius = circle->r;
+  satc_point_alloca(edge);
+  satc_point_alloca(point);
+  satc_point_alloca(other);
+  size_t i = 0;
+  for (; i < len; i++) {
+    size_t next = (i == len - 1) ? 0 : i + 1;
+    size_t prev = (i == 0) ? len - 1 : i - 1;
+    SATC_REAL overlap = 0.0;
+    bool found = false;
+    satc_point_set_xy(edge, polygon->edges.x[i], polygon->edges.y[i]);
+    satc_point_set_xy(point, cx - polygon->calc_points.x[i], cy - polygon->calc_points.y[i]);
+    if (satc_point_len2(point) > radius * radius) response->a_in_b = false;
+    int region = satc_voronoi_region(edge, point);
+    size_t vertex = i;
+    if (region != SATC_MIDDLE_VORONOI_REGION) {
+      size_t neighbor = region == SATC_LEFT_VORONOI_REGION ? prev : next;
+      vertex = region == SATC_LEFT_VORONOI_REGION ? i : next;
+      satc_point_set_xy(edge, polygon->edges.x[neighbor], polygon->edges.y[neighbor]);
+      satc_point_set_xy(other, cx - polygon->calc_points.x[neighbor], cy - polygon->calc_points.y[neighbor]);
+      if (satc_voronoi_region(edge, other) == -region) {
+        satc_point_set_xy(point, cx - polygon->calc_points.x[vertex], cy - polygon->calc_points.y[vertex]);
+        SATC_REAL dist = satc_point_len(point);
+        if (dist > radius) return false;
+        response->b_in_a = false;
+        satc_point_normalize(point);
+        overlap = radius - dist;
+        found = true;
+      }
+    } else {
+      satc_point_perp(edge);
+      satc_point_normalize(edge);
+      SATC_REAL dist = satc_point_dot(point, edge);
+      if (dist > 0.0 && SATC_FABS(dist) > radius) return false;
+      satc_point_copy(point, edge);
+      overlap = radius - dist;
+      if (dist >= 0.0 || overlap < 2.0 * radius) response->b_in_a = false;
+      found = true;
+    }
+    if (found && SATC_FABS(overlap) < SATC_FABS(response->overlap)) {
+      response->overlap = overlap;
+      satc_point_copy(response->overlap_n, point);
+    }
+  }
+  satc_point_copy(response->overlap_v, response->overlap_n);
+  satc_point_scale_x(response->overlap_v, response->overlap);
+  return true;
+}
+
+void satc_polygon_circle_kernel_test () {
+  satc_point_alloca_xy(pos, 0.0, 0.0);
+  satc_point_array_alloca(points, 12);
+  SATC_REAL coords[12][2];
+  size_t i = 0;
+  for (; i < 12; i++) points[i] = coords[i];
+
+  // Enough points for full SIMD batches and a remainder, a box, and a concave polygon.
+  SATC_REAL angles[12] = { 0.0, 0.4, 0.9, 1.1, 1.9, 2.3, 3.1, 3.3, 4.0, 4.8, 5.5, 6.0 };
+  for (i = 0; i < 12; i++) {
+    satc_point_set_xy(points[i], 9.0 * SATC_COS(angles[i]), 6.0 * SATC_SIN(angles[i]));
+  }
+  satc_polygon_t *polygons[4];
+  polygons[0] = satc_polygon_create(pos, 12, points);
+  satc_geometry_t *geometry = satc_geometry_create(12, points);
+  polygons[3] = satc_polygon_create_instance(pos, geometry);
+  satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 6.0, 3.0 };
+  polygons[1] = satc_box_to_polygon(&box);
+  satc_point_set_xy(points[0], 0.0, 0.0);
+  satc_point_set_xy(points[1], 10.0, 0.0);
+  satc_point_set_xy(points[2], 10.0, 10.0);
+  satc_point_set_xy(points[3], 5.0, 2.0);
+  satc_point_set_xy(points[4], 0.0, 10.0);
+  polygons[2] = satc_polygon_create(pos, 5, points);
+
+  // Results match walking the edges one at a time and normalizing each one.
+  satc_circle_t *circle = satc_circle_create(pos, 1.0);
+  size_t checked = 0;
+  size_t p = 0;
+  for (; p < 4; p++) {
+    satc_polygon_t *polygon = polygons[p];
+    satc_polygon_set_angle(polygon, 0.3 * p);
+    SATC_REAL radius = 0.5;
+    for (; radius < 12.0; radius *= 2.7) {
+      circle->r = radius;
+      SATC_REAL x = -17.0;
+      for (; x < 17.0; x += 1.37) {
+        SATC_REAL y = -13.0;
+        for (; y < 13.0; y += 1.19) {
+          satc_point_set_xy(circle->pos, x, y);
+          satc_response_t expected = SATC_RESPONSE_INIT;
+          satc_response_t response = SATC_RESPONSE_INIT;
+          bool collided = satc_test_polygon_circle_reference(polygon, circle, &expected);
+          assert(satc_test_polygon_circle(polygon, circle, NULL) == collided);
+          assert(satc_test_polygon_circle(polygon, circle, &response) == collided);
+          if (!collided) continue;
+          checked++;
+          satc_assert_near(response.overlap, expected.overlap);
+          satc_assert_near(response.overlap_n[0], expected.overlap_n[0]);
+          satc_assert_near(response.overlap_n[1], expected.overlap_n[1]);
+          assert(response.a_in_b == expected.a_in_b);
+          assert(response.b_in_a == expected.b_in_a);
+        }
+      }
+    }
+  }
+  assert(checked > 0);
+
+  satc_circle_destroy(circle);
+  for (p = 0; p < 4; p++) satc_polygon_destroy(polygons[p]);
+  satc_geometry_release(geometry);
+}
+
+void satc_hull_search_test () {
+  satc_point_alloca_xy(pos, 0.0, 0.0);
+  size_t num_points = 160;
+  satc_point_array_alloca(points, num_points);
+  SATC_REAL coords[160][2];
+  size_t i = 0;
+  for (; i < num_points; i++) points[i] = coords[i];
+  // An uneven arch over a flat floor, which has collinear points along the bottom.
+  satc_point_set_xy(points[0], 30.0, 0.0);
+  for (i = 1; i < 150; i++) {
+    SATC_REAL angle = M_PI * i / 150.0 + 0.004 * SATC_SIN(i * 1.7);
+    satc_point_set_xy(points[i], 30.0 * SATC_COS(angle), 12.0 * SATC_SIN(angle));
+  }
+  satc_point_set_xy(points[150], -30.0, 0.0);
+  for (i = 151; i < num_points; i++) {
+    satc_point_set_xy(points[i], -30.0 + 60.0 * (i - 150) / 10.0, 0.0);
+  }
+  satc_polygon_t *hull = satc_polygon_create(pos, num_points, points);
+  satc_polygon_update(hull);
+  assert(hull->normal_turn == 1);
+  assert(_satc_polygon_is_hull(hull));
+
+  // The same points in the opposite order turn the other way.
+  satc_point_array_alloca(reversed_points, num_points);
+  for (i = 0; i < num_points; i++) reversed_points[i] = points[num_points - 1 - i];
+  satc_polygon_t *reversed = satc_polygon_create(pos, num_points, reversed_points);
+  satc_polygon_update(reversed);
+  assert(reversed->normal_turn == -1);
+
+  // Searching finds the same range as projecting every point, along any axis.
+  satc_real_array_alloca(expected, 2);
+  satc_real_array_alloca(range, 2);
+  satc_point_alloca(axis);
+  satc_polygon_t *searched[2] = { hull, reversed };
+  size_t p = 0;
+  for (; p < 2; p++) {
+    satc_polygon_t *polygon = searched[p];
+    SATC_REAL angle = 0.0;
+    for (; angle < 6.3; angle += 0.05) {
+      satc_point_set_xy(axis, SATC_COS(angle), SATC_SIN(angle));
+      _satc_flatten_strided_points_on(num_points, polygon->calc_points.x, polygon->calc_points.y, 1, axis, expected);
+      _satc_flatten_hull_on(num_points, polygon->calc_points.x, polygon->calc_points.y, 1, &polygon->normals, polygon->normal_turn, axis, range);
+      satc_assert_near(range[0], expected[0]);
+      satc_assert_near(range[1], expected[1]);
+    }
+    // Including along the normals themselves, where whole edges tie.
+    for (i = 0; i < num_points; i++) {
+      satc_point_set_xy(axis, polygon->normals.x[i], polygon->normals.y[i]);
+      _satc_flatten_strided_points_on(num_points, polygon->calc_points.x, polygon->calc_points.y, 1, axis, expected);
+      _satc_flatten_hull_on(num_points, polygon->calc_points.x, polygon->calc_points.y, 1, &polygon->normals, polygon->normal_turn, axis, range);
+      satc_assert_near(range[0], expected[0]);
+      satc_assert_near(range[1], expected[1]);
+    }
+  }
+
+  // Polygon tests against the hull match projecting every point, in world and local space.
+  satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 5.0, 3.0 };
+  satc_polygon_t *other = satc_box_to_polygon(&box);
+  satc_polygon_set_angle(other, 0.4);
+  for (p = 0; p < 2; p++) {
+    satc_polygon_t *polygon = searched[p];
+    satc_polygon_set_angle(polygon, 0.3 * p);
+    SATC_REAL x = -36.0;
+    for (; x < 36.0; x += 2.9) {
+      SATC_REAL y = -8.0;
+      for (; y < 20.0; y += 1.7) {
+        satc_point_set_xy(other->pos, x, y);
+        satc_response_t expected_response = SATC_RESPONSE_INIT;
+        satc_response_t response = SATC_RESPONSE_INIT;
+        bool collided = satc_test_polygon_polygon_reference(other, polygon, &expected_response);
+        assert(satc_test_polygon_polygon(other, polygon, &response) == collided);
+        assert(satc_test_polygon_polygon(other, polygon, NULL) == collided);
+        assert(satc_test_polygon_polygon_local(other, polygon, NULL) == collided);
+        if (!collided) continue;
+        satc_assert_near(response.overlap, expected_response.overlap);
+        satc_assert_near(response.overlap_n[0], expected_response.overlap_n[0]);
+        satc_assert_near(response.overlap_n[1], expected_response.overlap_n[1]);
+        assert(response.a_in_b == expected_response.a_in_b);
+        assert(response.b_in_a == expected_response.b_in_a);
+      }
+    }
+  }
+
+  // Circle tests against the hull match walking every edge, inside and out.
+  // As always, they expect the points to go counter-clockwise.
+  satc_circle_t *circle = satc_circle_create(pos, 1.0);
+  SATC_REAL radius = 0.7;
+  for (; radius < 80.0; radius *= 3.1) {
+    circle->r = radius;
+    SATC_REAL x = -40.0;
+    for (; x < 40.0; x += 1.73) {
+      SATC_REAL y = -15.0;
+      for (; y < 25.0; y += 1.31) {
+        satc_point_set_xy(circle->pos, x, y);
+        satc_response_t expected_response = SATC_RESPONSE_INIT;
+        satc_response_t response = SATC_RESPONSE_INIT;
+        bool collided = satc_test_polygon_circle_reference(hull, circle, &expected_response);
+        assert(satc_test_polygon_circle(hull, circle, NULL) == collided);
+        assert(satc_test_polygon_circle(hull, circle, &response) == collided);
+        if (!collided) continue;
+        satc_assert_near(response.overlap, expected_response.overlap);
+        satc_assert_near(response.overlap_n[0], expected_response.overlap_n[0]);
+        satc_assert_near(response.overlap_n[1], expected_response.overlap_n[1]);
+        assert(response.a_in_b == expected_response.a_in_b);
+        assert(response.b_in_a == expected_response.b_in_a);
+      }
+    }
+  }
+
+  // Concave polygons and repeated points can not be searched.
+  satc_point_set_xy(points[75], 0.0, 3.0);
+  satc_polygon_set_points(hull, num_points, points);
+  satc_polygon_update(hull);
+  assert(hull->normal_turn == 0);
+  satc_point_set_xy(points[75], points[74][0], points[74][1]);
+  satc_polygon_set_points(hull, num_points, points);
+  satc_polygon_update(hull);
+  assert(hull->convex);
+  assert(hull->normal_turn == 0);
+
+  satc_circle_destroy(circle);
+  satc_polygon_destroy(other);
+  satc_polygon_destroy(reversed);
+  satc_polygon_destroy(hull);
+}
+
+satc_polygon_t *satc_gjk_test_ellipse (size_t num_points, SATC_REAL rx, SATC_REAL ry) {
+  satc_point_alloca_xy(pos, 0.0, 0.0);
+  satc_point_array_alloca(points, num_points);
+  SATC_REAL *coords = malloc(sizeof(SATC_REAL) * 2 * num_points);
+  size_t i = 0;
+  for (; i < num_points; i++) {
+    SATC_REAL angle = 2.0 * M_PI * i / num_points;
+    points[i] = coords + 2 * i;
+    satc_point_set_xy(points[i], rx * SATC_COS(angle), ry * SATC_SIN(angle));
+  }
+  satc_polygon_t *polygon = satc_polygon_create(pos, num_points, points);
+  free(coords);
+  return polygon;
+}
+
+void satc_gjk_test () {
+  // A hull large enough to be searched, a hexagon, and a box.
+  satc_polygon_t *shapes[3];
+  shapes[0] = satc_gjk_test_ellipse(200, 20.0, 12.0);
+  shapes[1] = satc_gjk_test_ellipse(6, 5.0, 5.0);
+  satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 7.0, 3.0 };
+  shapes[2] = satc_box_to_polygon(&box);
+  satc_polygon_update(shapes[0]);
+  assert(_satc_polygon_is_hull(shapes[0]));
+  satc_polygon_set_angle(shapes[0], 0.2);
+  satc_polygon_set_angle(shapes[1], 0.1);
+  satc_point_alloca_xy(c_pos, 0.0, 0.0);
+  satc_circle_t *circle = satc_circle_create(c_pos, 4.0);
+  satc_circle_t *small_circle = satc_circle_create(c_pos, 1.5);
+  satc_circle_t *circles[2] = { circle, small_circle };
+
+  // GJK and EPA agree with the separating axis test, including containment.
+  size_t p = 0;
+  for (; p < 3; p++) {
+    size_t q = 0;
+    for (; q < 3; q++) {
+      if (p == q) continue;
+      satc_polygon_t *a = shapes[p];
+      satc_polygon_t *b = shapes[q];
+      SATC_REAL x = -31.3;
+      for (; x < 31.0; x += 2.37) {
+        SATC_REAL y = -21.1;
+        for (; y < 21.0; y += 1.93) {
+          satc_point_set_xy(b->pos, x, y);
+          satc_response_t expected = SATC_RESPONSE_INIT;
+          satc_response_t response = SATC_RESPONSE_INIT;
+          bool collided = satc_test_polygon_polygon(a, b, &expected);
+          assert(satc_gjk_test_polygon_polygon(a, b, &response) == collided);
+          assert(satc_gjk_test_polygon_polygon(a, b, NULL) == collided);
+          assert(satc_test_shapes(a, b, satc_narrowphase_gjk, NULL) == collided);
+          if (collided) {
+            satc_assert_responses_near(&response, &expected);
+            assert(satc_gjk_distance(a, b) == 0.0);
+          } else {
+            assert(satc_gjk_distance(a, b) > 0.0);
+          }
+        }
+      }
+      satc_point_set_xy(b->pos, 0.0, 0.0);
+    }
+
+    size_t c = 0;
+    for (; c < 2; c++) {
+      satc_circle_t *other = circles[c];
+      SATC_REAL x = -27.3;
+      for (; x < 27.0; x += 1.37) {
+        SATC_REAL y = -17.1;
+        for (; y < 17.0; y += 1.13) {
+          satc_point_set_xy(other->pos, x, y);
+          satc_response_t expected = SATC_RESPONSE_INIT;
+          satc_response_t response = SATC_RESPONSE_INIT;
+          bool collided = satc_test_polygon_circle(shapes[p], other, &expected);
+          assert(satc_gjk_test_polygon_circle(shapes[p], other, &response) == collided);
+          assert(satc_gjk_test_polygon_circle(shapes[p], other, NULL) == collided);
+          if (collided) satc_assert_responses_near(&response, &expected);
+          collided = satc_test_circle_polygon(other, shapes[p], &expected);
+          assert(satc_test_shapes(other, shapes[p], satc_narrowphase_gjk, &response) == collided);
+          if (collided) satc_assert_responses_near(&response, &expected);
+        }
+      }
+    }
+  }
+
+  // Distances between shapes which do not overlap.
+  satc_polygon_set_angle(shapes[1], 0.0);
+  satc_point_set_xy(shapes[2]->pos, 20.0, -1.0);
+  satc_point_set_xy(circle->pos, 0.0, 15.0);
+  satc_assert_near(satc_gjk_distance(shapes[1], shapes[2]), 15.0);
+  satc_assert_near(satc_gjk_distance(shapes[2], shapes[1]), 15.0);
+  satc_assert_near(satc_gjk_distance(circle, shapes[1]), 15.0 - 4.0 - 5.0 * SATC_SIN(M_PI / 3.0));
+  satc_point_set_xy(small_circle->pos, 0.0, 5.0);
+  satc_assert_near(satc_gjk_distance(circle, small_circle), 10.0 - 5.5);
+
+  // Two circles are tested directly, and the separating axis test can be picked instead.
+  satc_response_t expected = SATC_RESPONSE_INIT;
+  satc_response_t response = SATC_RESPONSE_INIT;
+  satc_point_set_xy(small_circle->pos, 0.0, 10.0);
+  assert(satc_test_shapes(circle, small_circle, satc_narrowphase_gjk, &response));
+  assert(satc_test_circle_circle(circle, small_circle, &expected));
+  satc_assert_responses_near(&response, &expected);
+  assert(satc_test_shapes(shapes[1], small_circle, satc_narrowphase_sat, &response) == satc_test_polygon_circle(shapes[1], small_circle, NULL));
+  assert(!satc_test_shapes(&box, circle, satc_narrowphase_gjk, &response));
+
+  satc_circle_destroy(small_circle);
+  satc_circle_destroy(circle);
+  for (p = 0; p < 3; p++) satc_polygon_destroy(shapes[p]);
+}
+
+void satc_transform_test () {
+  {
+    // Transforms cache their trig and bump their version when they change.
+    satc_transform_t identity = SATC_TRANSFORM_INIT;
+    satc_vec2_t v = satc_transform_apply(&identity, satc_vec2(1.0, 2.0));
+    satc_assert_near(v.x, 1.0);
+    satc_assert_near(v.y, 2.0);
+
+    satc_transform_t transform;
+    satc_point_alloca_xy(pos, 5.0, 0.0);
+    satc_transform_init(&transform, pos, M_PI / 2.0);
+    assert(transform.version == 0);
+    satc_assert_near(satc_point_get_x(transform.rotation), 0.0);
+    satc_assert_near(satc_point_get_y(transform.rotation), 1.0);
+    v = satc_transform_apply(&transform, satc_vec2(1.0, 0.0));
+    satc_assert_near(v.x, 5.0);
+    satc_assert_near(v.y, 1.0);
+
+    satc_transform_set_angle(&transform, M_PI / 2.0);
+    assert(transform.version == 0);
+    satc_transform_set_angle(&transform, M_PI);
+    assert(transform.version == 1);
+    satc_transform_set_pos(&transform, pos);
+    assert(transform.version == 2);
+  }
+
+  {
+    // Polygons sharing a transform follow it, and match polygons which were
+    // positioned and rotated on their own.
+    satc_point_array_alloca(points, 4);
+    satc_point_alloca_xy(a, -10.0, -5.0);
+    satc_point_alloca_xy(b, 10.0, -5.0);
+    satc_point_alloca_xy(c, 10.0, 5.0);
+    satc_point_alloca_xy(d, -10.0, 5.0);
+    points[0] = a;
+    points[1] = b;
+    points[2] = c;
+    points[3] = d;
+    satc_point_alloca_xy(origin, 0.0, 0.0);
+    satc_polygon_t *polygon_1 = satc_polygon_create(origin, 4, points);
+    satc_polygon_t *polygon_2 = satc_polygon_create(origin, 4, points);
+    satc_point_alloca_xy(offset, 0.0, 8.0);
+    satc_polygon_set_offset(polygon_2, offset);
+
+    satc_transform_t transform;
+    satc_point_alloca_xy(pos, 100.0, 50.0);
+    satc_transform_init(&transform, pos, M_PI / 6.0);
+    satc_polygon_set_transform(polygon_1, &transform);
+    satc_polygon_set_transform(polygon_2, &transform);
+    satc_assert_near(satc_point_get_x(polygon_1->pos), 100.0);
+    satc_assert_near(polygon_2->angle, M_PI / 6.0);
+
+    satc_point_alloca_xy(moved, 120.0, 40.0);
+    satc_transform_set_pos(&transform, moved);
+    satc_transform_set_angle(&transform, M_PI / 3.0);
+
+    satc_polygon_t *reference = satc_polygon_create(moved, 4, points);
+    satc_polygon_set_offset(reference, offset);
+    satc_polygon_set_angle(reference, M_PI / 3.0);
+
+    satc_aabb_t bounds;
+    satc_aabb_t reference_bounds;
+    satc_polygon_get_bounds(polygon_2, &bounds);
+    satc_polygon_get_bounds(reference, &reference_bounds);
+    satc_assert_near(satc_point_get_x(polygon_2->pos), 120.0);
+    satc_assert_near(satc_point_get_x(bounds.min), satc_point_get_x(reference_bounds.min));
+    satc_assert_near(satc_point_get_y(bounds.min), satc_point_get_y(reference_bounds.min));
+    satc_assert_near(satc_point_get_x(bounds.max), satc_point_get_x(reference_bounds.max));
+    satc_assert_near(satc_point_get_y(bounds.max), satc_point_get_y(reference_bounds.max));
+    size_t i = 0;
+    for (; i < 4; i++) {
+      satc_assert_near(polygon_2->calc_points.x[i], reference->calc_points.x[i]);
+      satc_assert_near(polygon_2->calc_points.y[i], reference->calc_points.y[i]);
+      satc_assert_near(polygon_2->normals.x[i], reference->normals.x[i]);
+      satc_assert_near(polygon_2->normals.y[i], reference->normals.y[i]);
+    }
+
+    // Both polygons moved with the transform, so they still overlap.
+    satc_response_t response = SATC_RESPONSE_INIT;
+    assert(satc_test_polygon_polygon(polygon_1, polygon_2, &response));
+    satc_assert_near(satc_point_get_x(polygon_1->pos), 120.0);
+    satc_assert_near(polygon_1->angle, M_PI / 3.0);
+
+    // Detached polygons keep their last position.
+    satc_polygon_set_transform(polygon_1, NULL);
+    satc_transform_set_pos(&transform, origin);
+    satc_polygon_update(polygon_1);
+    satc_assert_near(satc_point_get_x(polygon_1->pos), 120.0);
+
+    satc_polygon_destroy(reference);
+    satc_polygon_destroy(polygon_2);
+    satc_polygon_destroy(polygon_1);
+  }
+}
+
+void satc_arena_test () {
+  {
+    // Shapes and responses can be carved out of a caller-owned block.
+    unsigned char buffer[8192];
+    satc_arena_t arena;
+    satc_arena_init(&arena, buffer, sizeof(buffer));
+
+    satc_point_alloca_xy(pos_1, 0.0, 0.0);
+    satc_point_alloca_xy(pos_2, 10.0, 0.0);
+    satc_box_t *box = satc_box_create_in(&arena, pos_1, 20.0, 20.0);
+    satc_polygon_t *polygon_1 = satc_box_to_polygon_in(&arena, box);
+    satc_polygon_t *polygon_2 = satc_polygon_get_aabb_in(&arena, polygon_1);
+    satc_point_copy(polygon_2->pos, pos_2);
+    satc_response_t *response = satc_response_create_in(&arena);
+    assert(box != NULL);
+    assert(polygon_1 != NULL);
+    assert(polygon_2 != NULL);
+    assert(response != NULL);
+    assert(polygon_1->arena == &arena);
+    assert((unsigned char *) polygon_1->storage >= buffer);
+    assert((unsigned char *) polygon_1->storage < buffer + sizeof(buffer));
+    assert((uintptr_t) polygon_1->storage % SATC_ARENA_ALIGNMENT == 0);
+
+    bool collided = satc_test_polygon_polygon(polygon_1, polygon_2, response);
+    assert(collided);
+    satc_assert_near(response->overlap, 10.0);
+
+    satc_circle_t *circle = satc_circle_create_in(&arena, pos_2, 5.0);
+    satc_polygon_t *circle_aabb = satc_circle_get_aabb_in(&arena, circle);
+    assert(circle_aabb != NULL);
+    satc_assert_near(satc_point_get_x(circle_aabb->pos), 5.0);
+    satc_assert_near(satc_point_get_y(circle_aabb->pos), -5.0);
+
+    // Arena polygons may be destroyed, but only a reset gives memory back.
+    size_t used = arena.used;
+    satc_polygon_destroy(circle_aabb);
+    assert(arena.used == used);
+
+    // A polygon which outgrows its storage moves to a new block of the
+    // arena, and the old block stays used until the reset.
+    size_t num_points = polygon_1->capacity + 1;
+    SATC_REAL coords[SATC_SMALL_POLYGON_CAPACITY + 1][2];
+    SATC_REAL *points[SATC_SMALL_POLYGON_CAPACITY + 1];
+    size_t i = 0;
+    for (; i < num_points; i++) {
+      coords[i][0] = 10.0 * SATC_COS((SATC_REAL) i);
+      coords[i][1] = 10.0 * SATC_SIN((SATC_REAL) i);
+      points[i] = coords[i];
+    }
+    SATC_REAL *old_storage = polygon_1->storage;
+    assert(satc_polygon_set_points(polygon_1, num_points, points) == polygon_1);
+    assert((unsigned char *) polygon_1->storage > (unsigned char *) old_storage);
+    assert(arena.used >= used + sizeof(SATC_REAL) * num_points * 12);
+
+    satc_arena_reset(&arena);
+    assert(arena.used == 0);
+    satc_circle_t *reused = satc_circle_create_in(&arena, pos_1, 1.0);
+    assert((unsigned char *) reused - buffer < SATC_ARENA_ALIGNMENT);
+  }
+
+  {
+    // Running out of room returns NULL instead of overflowing the block.
+    unsigned char buffer[sizeof(satc_polygon_t) + SATC_ARENA_ALIGNMENT];
+    satc_arena_t arena;
+    satc_arena_init(&arena, buffer, sizeof(buffer));
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 1.0, 1.0 };
+    assert(satc_box_to_polygon_in(&arena, &box) == NULL);
+    assert(arena.used == 0);
+    assert(satc_circle_create_in(&arena, pos, 1.0) != NULL);
+    while (satc_circle_create_in(&arena, pos, 1.0) != NULL);
+    assert(arena.used <= arena.size);
+  }
+}
+
+void satc_aabb_test () {
+  {
+    // Bounding boxes which only touch still overlap.
+    satc_aabb_t a = { { 0.0, 0.0 }, { 10.0, 10.0 } };
+    satc_aabb_t b = { { 10.0, 5.0 }, { 20.0, 15.0 } };
+    satc_aabb_t c = { { 10.5, 5.0 }, { 20.0, 15.0 } };
+    satc_aabb_t d = { { 0.0, -20.0 }, { 10.0, -0.5 } };
+    assert(satc_aabb_overlaps(&a, &b));
+    assert(satc_aabb_overlaps(&b, &a));
+    assert(!satc_aabb_overlaps(&a, &c));
+    assert(!satc_aabb_overlaps(&c, &a));
+    assert(!satc_aabb_overlaps(&a, &d));
+    assert(!satc_aabb_overlaps(&d, &a));
+  }
+
+  {
+    // Circle bounds follow the circle's position and radius.
+    satc_point_alloca_xy(pos, 5.0, -5.0);
+    satc_circle_t *circle = satc_circle_create(pos, 2.0);
+    satc_aabb_t bounds;
+    satc_circle_get_bounds(circle, &bounds);
+    satc_assert_near(satc_point_get_x(bounds.min), 3.0);
+    satc_assert_near(satc_point_get_y(bounds.min), -7.0);
+    satc_assert_near(satc_point_get_x(bounds.max), 7.0);
+    satc_assert_near(satc_point_get_y(bounds.max), -3.0);
+    satc_circle_destroy(circle);
+  }
+
+  {
+    // Cached polygon bounds follow changes to the position.
+    satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 20.0, 10.0 };
+    satc_polygon_t *polygon = satc_box_to_polygon(&box);
+    satc_point_set_xy(polygon->pos, 100.0, 50.0);
+    satc_aabb_t bounds;
+    satc_polygon_get_bounds(polygon, &bounds);
+    satc_assert_near(satc_point_get_x(bounds.min), 100.0);
+    satc_assert_near(satc_point_get_y(bounds.min), 50.0);
+    satc_assert_near(satc_point_get_x(bounds.max), 120.0);
+    satc_assert_near(satc_point_get_y(bounds.max), 60.0);
+    satc_polygon_destroy(polygon);
+  }
+
+  {
+    // Near misses are rejected by their bounding boxes, and touching shapes
+    // still collide.
+    satc_box_t box_1 = { satc_type_box, { 0.0, 0.0 }, 20.0, 20.0 };
+    satc_box_t box_2 = { satc_type_box, { 20.0, 0.0 }, 20.0, 20.0 };
+    satc_polygon_t *polygon_1 = satc_box_to_polygon(&box_1);
+    satc_polygon_t *polygon_2 = satc_box_to_polygon(&box_2);
+    satc_response_t response = SATC_RESPONSE_INIT;
+    assert(satc_test_polygon_polygon(polygon_1, polygon_2, &response));
+    satc_assert_near(response.overlap, 0.0);
+    satc_point_set_xy(polygon_2->pos, 20.5, 0.0);
+    assert(!satc_test_polygon_polygon(polygon_1, polygon_2, &response));
+    assert(response.a == NULL);
+
+    satc_point_alloca_xy(circle_pos, 30.0, 10.0);
+    satc_circle_t *circle = satc_circle_create(circle_pos, 10.0);
+    assert(satc_test_polygon_circle(polygon_1, circle, &response));
+    satc_assert_near(response.overlap, 0.0);
+    satc_point_set_xy(circle->pos, 30.5, 10.0);
+    assert(!satc_test_polygon_circle(polygon_1, circle, &response));
+    assert(!satc_test_circle_polygon(circle, polygon_1, &response));
+
+    satc_circle_destroy(circle);
+    satc_polygon_destroy(polygon_2);
+    satc_polygon_destroy(polygon_1);
+  }
+}
+
+void satc_axis_cache_test () {
+  satc_polygon_t *hexagon = satc_gjk_test_ellipse(6, 5.0, 5.0);
+  satc_box_t box = { satc_type_box, { 0.0, 0.0 }, 7.0, 3.0 };
+  satc_polygon_t *other = satc_box_to_polygon(&box);
+  satc_polygon_set_angle(other, 0.4);
+
+  // The box is just off the hexagon's right side, inside its bounding box.
+  satc_axis_cache_t cache = SATC_AXIS_CACHE_INIT;
+  assert(cache.place == SIZE_MAX);
+  satc_point_set_xy(other->pos, 6.0, -2.0);
+  assert(!satc_test_polygon_polygon_cached(hexagon, other, &cache, NULL));
+  assert(cache.place < hexagon->num_points + other->num_points);
+  // While the pair stays apart, the same axis is remembered.
+  size_t place = cache.place;
+  satc_point_set_xy(other->pos, 6.1, -1.9);
+  assert(!satc_test_polygon_polygon_cached(hexagon, other, &cache, NULL));
+  assert(cache.place == place);
+  // Once they overlap, the cache holds the axis of the overlap.
+  satc_response_t expected = SATC_RESPONSE_INIT;
+  satc_response_t response = SATC_RESPONSE_INIT;
+  satc_point_set_xy(other->pos, 4.0, 0.5);
+  assert(satc_test_polygon_polygon_cached(hexagon, other, &cache, &response));
+  assert(satc_test_polygon_polygon(hexagon, other, &expected));
+  assert(cache.place < hexagon->num_points + other->num_points);
+  satc_assert_near(response.overlap, expected.overlap);
+  // A place which no longer fits the polygons is ignored.
+  cache.place = 100;
+  assert(satc_test_polygon_polygon_cached(hexagon, other, &cache, NULL));
+
+  // Along a path around the hexagon, the results match the uncached test.
+  cache = (satc_axis_cache_t) SATC_AXIS_CACHE_INIT;
+  satc_axis_cache_t response_cache = SATC_AXIS_CACHE_INIT;
+  SATC_REAL t = 0.0;
+  for (; t < 12.6; t += 0.037) {
+    satc_point_set_xy(other->pos, (6.0 + 3.0 * SATC_SIN(t * 3.0)) * SATC_COS(t), (6.0 + 3.0 * SATC_SIN(t * 3.0)) * SATC_SIN(t));
+    satc_polygon_set_angle(other, t);
+    bool collided = satc_test_polygon_polygon(hexagon, other, &expected);
+    assert(satc_test_polygon_polygon_cached(hexagon, other, &cache, NULL) == collided);
+    assert(satc_test_polygon_polygon_cached(hexagon, other, &response_cache, &response) == collided);
+    if (!collided) continue;
+    satc_assert_near(response.overlap, expected.overlap);
+    satc_assert_near(response.overlap_n[0], expected.overlap_n[0]);
+    satc_assert_near(response.overlap_n[1], expected.overlap_n[1]);
+    assert(response.a_in_b == expected.a_in_b);
+    assert(response.b_in_a == expected.b_in_a);
+  }
+
+  satc_polygon_destroy(other);
+  satc_polygon_destroy(hexagon);
+}
+
+void satc_test_many_test () {
+  // A row of circles and polygons of several sizes, some of them large
+  // enough to be searched as hulls, with a box which is never hit.
+  size_t count = 30;
+  void *shapes[30];
+  size_t i = 0;
+  for (; i < count; i++) {
+    SATC_REAL x = -15.0 + (SATC_REAL) i;
+    SATC_REAL y = (SATC_REAL) (i % 5) - 2.0;
+    if (i == 17) {
+      satc_point_alloca_xy(box_pos, x, y);
+      shapes[i] = satc_box_create(box_pos, 2.0, 2.0);
+    } else if (i % 3 == 0) {
+      satc_point_alloca_xy(pos, x, y);
+      shapes[i] = satc_circle_create(pos, 0.5 + 0.1 * (SATC_REAL) (i % 4));
+    } else {
+      size_t num_points = i % 3 == 1 ? 4 : 160;
+      satc_polygon_t *polygon = satc_gjk_test_ellipse(num_points, 1.5, 0.75);
+      satc_polygon_set_angle(polygon, 0.3 * (SATC_REAL) i);
+      satc_point_set_xy(polygon->pos, x, y);
+      shapes[i] = polygon;
+    }
+  }
+
+  size_t hits[30];
+  size_t expected_hits[30];
+  satc_response_t responses[30];
+  satc_response_t expected = SATC_RESPONSE_INIT;
+  satc_polygon_t *query = satc_gjk_test_ellipse(7, 4.0, 2.5);
+  satc_point_alloca_xy(circle_pos, 0.0, 0.0);
+  satc_circle_t *circle = satc_circle_create(circle_pos, 3.0);
+  SATC_REAL t = 0.0;
+  for (; t < 6.3; t += 0.21) {
+    satc_polygon_set_angle(query, t);
+    satc_point_set_xy(query->pos, 8.0 * SATC_COS(t), SATC_SIN(t));
+    satc_point_set_xy(circle->pos, 8.0 * SATC_SIN(t), SATC_COS(t));
+
+    // The polygon finds the same shapes, with the same responses, as one
+    // test at a time.
+    size_t num_expected = 0;
+    for (i = 0; i < count; i++) {
+      int type = *(int *) shapes[i];
+      if (type == satc_type_circle && satc_test_polygon_circle(query, shapes[i], NULL)) {
+        expected_hits[num_expected++] = i;
+      } else if (type == satc_type_polygon && satc_test_polygon_polygon(query, shapes[i], NULL)) {
+        expected_hits[num_expected++] = i;
+      }
+    }
+    assert(satc_test_polygon_many(query, count, shapes, hits, NULL) == num_expected);
+    assert(satc_test_polygon_many(query, count, shapes, hits, responses) == num_expected);
+    for (i = 0; i < num_expected; i++) {
+      assert(hits[i] == expected_hits[i]);
+      if (*(int *) shapes[hits[i]] == satc_type_circle) {
+        satc_test_polygon_circle(query, shapes[hits[i]], &expected);
+      } else {
+        satc_test_polygon_polygon(query, shapes[hits[i]], &expected);
+      }
+      satc_assert_responses_near(&responses[i], &expected);
+    }
+
+    // So does the circle.
+    num_expected = 0;
+    for (i = 0; i < count; i++) {
+      int type = *(int *) shapes[i];
+      if (type == satc_type_circle && satc_test_circle_circle(circle, shapes[i], NULL)) {
+        expected_hits[num_expected++] = i;
+      } else if (type == satc_type_polygon && satc_test_circle_polygon(circle, shapes[i], NULL)) {
+        expected_hits[num_expected++] = i;
+      }
+    }
+    assert(num_expected > 0);
+    assert(satc_test_circle_many(circle, count, shapes, hits, responses) == num_expected);
+    for (i = 0; i < num_expected; i++) {
+      assert(hits[i] == expected_hits[i]);
+      if (*(int *) shapes[hits[i]] == satc_type_circle) {
+        satc_test_circle_circle(circle, shapes[hits[i]], &expected);
+      } else {
+        satc_test_circle_polygon(circle, shapes[hits[i]], &expected);
+      }
+      satc_assert_responses_near(&responses[i], &expected);
+    }
+  }
+
+  // Nothing is hit from an empty array.
+  assert(satc_test_polygon_many(query, 0, shapes, hits, responses) == 0);
+  assert(satc_test_circle_many(circle, 0, shapes, hits, NULL) == 0);
+
+  satc_circle_destroy(circle);
+  satc_polygon_destroy(query);
+  for (i = 0; i < count; i++) {
+    int type = *(int *) shapes[i];
+    if (type == satc_type_circle) {
+      satc_circle_destroy(shapes[i]);
+    } else if (type == satc_type_polygon) {
+      satc_polygon_destroy(shapes[i]);
+    } else {
+      satc_box_destroy(shapes[i]);
+    }
+  }
+}
+
+void satc_test_pairs_test () {
+  // Circles, polygons, and a box, close enough that many of them overlap.
+  size_t num_shapes = 26;
+  void *shapes[26];
+  size_t i = 0;
+  for (; i < num_shapes; i++) {
+    SATC_REAL x = 3.0 * SATC_COS((SATC_REAL) i * 1.7);
+    SATC_REAL y = 3.0 * SATC_SIN((SATC_REAL) i * 2.3);
+    if (i == 11) {
+      satc_point_alloca_xy(box_pos, x, y);
+      shapes[i] = satc_box_create(box_pos, 2.0, 2.0);
+    } else if (i % 3 == 0) {
+      satc_point_alloca_xy(pos, x, y);
+      shapes[i] = satc_circle_create(pos, 0.5 + 0.2 * (SATC_REAL) (i % 4));
+    } else {
+      satc_polygon_t *polygon = satc_gjk_test_ellipse(i % 3 == 1 ? 4 : 9, 1.5, 0.75);
+      satc_polygon_set_angle(polygon, 0.3 * (SATC_REAL) i);
+      satc_point_set_xy(polygon->pos, x, y);
+      shapes[i] = polygon;
+    }
+  }
+
+  // Every pair, which is more than one batch.
+  size_t count = num_shapes * (num_shapes - 1) / 2;
+  assert(count > SATC_PAIR_BATCH);
+  satc_pair_t pairs[325];
+  size_t k = 0;
+  for (i = 0; i < num_shapes; i++) {
+    size_t j = i + 1;
+    for (; j < num_shapes; j++) {
+      pairs[k].a = (i + j) % 2 == 0 ? i : j;
+      pairs[k].b = (i + j) % 2 == 0 ? j : i;
+      k++;
+    }
+  }
+
+  bool hit[325];
+  SATC_REAL overlap[325];
+  SATC_REAL overlap_x[325];
+  SATC_REAL overlap_y[325];
+  bool a_in_b[325];
+  bool b_in_a[325];
+  satc_pair_results_t results = { hit, overlap, { overlap_x, overlap_y }, a_in_b, b_in_a };
+  size_t num_hits = satc_test_pairs(shapes, count, pairs, &results);
+
+  // The results match testing one pair at a time.
+  satc_response_t expected = SATC_RESPONSE_INIT;
+  size_t num_expected = 0;
+  for (k = 0; k < count; k++) {
+    void *a = shapes[pairs[k].a];
+    void *b = shapes[pairs[k].b];
+    int a_type = *(int *) a;
+    int b_type = *(int *) b;
+    bool collided = false;
+    if (a_type == satc_type_circle && b_type == satc_type_circle) {
+      collided = satc_test_circle_circle(a, b, &expected);
+    } else if (a_type == satc_type_polygon && b_type == satc_type_circle) {
+      collided = satc_test_polygon_circle(a, b, &expected);
+    } else if (a_type == satc_type_circle && b_type == satc_type_polygon) {
+      collided = satc_test_circle_polygon(a, b, &expected);
+    } else if (a_type == satc_type_polygon && b_type == satc_type_polygon) {
+      collided = satc_test_polygon_polygon(a, b, &expected);
+    }
+    assert(hit[k] == collided);
+    if (!collided) {
+      assert(overlap[k] == 0.0 && overlap_x[k] == 0.0 && overlap_y[k] == 0.0);
+      assert(!a_in_b[k] && !b_in_a[k]);
+      continue;
+    }
+    num_expected++;
+    satc_assert_near(overlap[k], expected.overlap);
+    satc_assert_near(overlap_x[k], expected.overlap_n[0]);
+    satc_assert_near(overlap_y[k], expected.overlap_n[1]);
+    assert(a_in_b[k] == expected.a_in_b);
+    assert(b_in_a[k] == expected.b_in_a);
+  }
+  assert(num_expected > 0 && num_expected < count);
+  assert(num_hits == num_expected);
+
+  // Results may leave out everything but the hits, or only some arrays.
+  bool only_hit[325];
+  satc_pair_results_t hits_only = { only_hit, NULL, { NULL, NULL }, NULL, NULL };
+  assert(satc_test_pairs(shapes, count, pairs, &hits_only) == num_hits);
+  SATC_REAL only_overlap[325];
+  satc_pair_results_t overlaps_only = { only_hit, only_overlap, { NULL, NULL }, NULL, NULL };
+  assert(satc_test_pairs(shapes, count, pairs, &overlaps_only) == num_hits);
+  for (k = 0; k < count; k++) {
+    assert(only_hit[k] == hit[k]);
+    satc_assert_near(only_overlap[k], overlap[k]);
+  }
+  assert(satc_test_pairs(shapes, 0, pairs, &results) == 0);
+
+  {
+    // Circles which only just touch get the same answer as from
+    // `satc_test_circle_circle`, whether or not there are responses.
+    satc_point_alloca_xy(pos, 0.1, 0.3);
+    void *touching[33];
+    satc_pair_t touching_pairs[32];
+    bool touching_hit[32];
+    size_t touching_hits[32];
+    satc_pair_results_t touching_results = { touching_hit, NULL, { NULL, NULL }, NULL, NULL };
+    touching[0] = satc_circle_create(pos, 1.0);
+    for (i = 1; i < 33; i++) {
+      SATC_REAL dx = 2.0 * SATC_COS((SATC_REAL) i * 0.73);
+      SATC_REAL dy = 2.0 * SATC_SIN((SATC_REAL) i * 0.73);
+      satc_point_set_xy(pos, 0.1 + dx, 0.3 + dy);
+      touching[i] = satc_circle_create(pos, SATC_SQRT(dx * dx + dy * dy) - 1.0);
+      touching_pairs[i - 1].a = 0;
+      touching_pairs[i - 1].b = i;
+    }
+    size_t num_touching = satc_test_pairs(touching, 32, touching_pairs, &touching_results);
+    assert(satc_test_circle_many(touching[0], 32, touching + 1, touching_hits, NULL) == num_touching);
+    size_t num_touches = 0;
+    for (k = 0; k < 32; k++) {
+      bool touches = satc_test_circle_circle(touching[0], touching[k + 1], NULL);
+      assert(touching_hit[k] == touches);
+      num_touches += touches;
+    }
+    assert(num_touches > 0 && num_touches < 32);
+    assert(num_touching == num_touches);
+    for (i = 0; i < 33; i++) satc_circle_destroy(touching[i]);
+  }
+
+  for (i = 0; i < num_shapes; i++) {
+    int type = *(int *) shapes[i];
+    if (type == satc_type_circle) {
+      satc_circle_destroy(shapes[i]);
+    } else if (type == satc_type_polygon) {
+      satc_polygon_destroy(shapes[i]);
+    } else {
+      satc_box_destroy(shapes[i]);
+    }
+  }
+}
+
+void satc_circle_set_test () {
+  // Two sets, one more than a block long, filled in scattered order.
+  satc_circle_set_t *a = satc_circle_set_create(300);
+  satc_circle_set_t *b = satc_circle_set_create(70);
+  assert(a->count == 0 && a->capacity == 300);
+  size_t i = 0;
+  for (; i < 300; i++) {
+    satc_point_alloca_xy(pos, (SATC_REAL) ((i * 37) % 101) * 0.4, (SATC_REAL) ((i * 53) % 89) * 0.4);
+    assert(satc_circle_set_add(a, pos, 0.2 + (SATC_REAL) (i % 7) * 0.15) == i);
+  }
+  for (i = 0; i < 70; i++) {
+    satc_point_alloca_xy(pos, (SATC_REAL) ((i * 29) % 83) * 0.5, (SATC_REAL) ((i * 17) % 71) * 0.5);
+    satc_circle_set_add(b, pos, 0.1 + (SATC_REAL) (i % 5) * 0.3);
+  }
+  satc_point_alloca_xy(full_pos, 0.0, 0.0);
+  satc_circle_set_t *full = satc_circle_set_create(1);
+  assert(satc_circle_set_add(full, full_pos, 1.0) == 0);
+  assert(satc_circle_set_add(full, full_pos, 1.0) == SIZE_MAX);
+  assert(full->count == 1);
+  satc_circle_set_destroy(full);
+
+  // A circle against a set matches testing one circle at a time.
+  satc_point_alloca_xy(circle_pos, 17.0, 15.0);
+  satc_circle_t *circle = satc_circle_create(circle_pos, 5.0);
+  satc_circle_t *other = satc_circle_create(circle_pos, 1.0);
+  satc_response_t expected = SATC_RESPONSE_INIT;
+  size_t hits[300];
+  size_t inside[300];
+  SATC_REAL overlap_x[300];
+  SATC_REAL overlap_y[300];
+  satc_points_t overlap_v = { overlap_x, overlap_y };
+  size_t num_hits = satc_test_circle_circle_set(circle, a, hits, &overlap_v);
+  size_t num_inside = satc_circle_set_find_inside(circle, a, inside);
+  assert(satc_test_circle_circle_set(circle, a, hits, NULL) == num_hits);
+  size_t k = 0;
+  size_t m = 0;
+  for (i = 0; i < a->count; i++) {
+    satc_point_set_xy(other->pos, a->x[i], a->y[i]);
+    other->r = a->r[i];
+    if (!satc_test_circle_circle(circle, other, &expected)) continue;
+    assert(hits[k] == i);
+    satc_assert_near(overlap_x[k], expected.overlap_v[0]);
+    satc_assert_near(overlap_y[k], expected.overlap_v[1]);
+    k++;
+    if (expected.b_in_a) assert(inside[m++] == i);
+  }
+  assert(k == num_hits && num_hits > 0 && num_hits < a->count);
+  assert(m == num_inside && num_inside > 0 && num_inside < num_hits);
+
+  {
+    // Circles which only just touch the circle, or only just fit inside it,
+    // are found exactly when `satc_test_circle_circle` says so, in the SIMD
+    // lanes and in the circles after them.
+    satc_point_alloca_xy(center, 0.1, 0.3);
+    satc_circle_t *edge = satc_circle_create(center, 3.3);
+    satc_circle_set_t *set = satc_circle_set_create(99);
+    for (i = 0; i < 99; i++) {
+      SATC_REAL distance = i % 2 == 0 ? 5.0 : 0.4;
+      SATC_REAL dx = distance * SATC_COS((SATC_REAL) i * 1.1);
+      SATC_REAL dy = distance * SATC_SIN((SATC_REAL) i * 1.1);
+      SATC_REAL length = SATC_SQRT(dx * dx + dy * dy);
+      satc_point_alloca_xy(pos, 0.1 + dx, 0.3 + dy);
+      satc_circle_set_add(set, pos, i % 2 == 0 ? length - 3.3 : 3.3 - length);
+    }
+    num_hits = satc_test_circle_circle_set(edge, set, hits, NULL);
+    num_inside = satc_circle_set_find_inside(edge, set, inside);
+    k = 0;
+    m = 0;
+    size_t num_touching = 0;
+    for (i = 0; i < set->count; i++) {
+      satc_point_set_xy(other->pos, set->x[i], set->y[i]);
+      other->r = set->r[i];
+      bool collided = satc_test_circle_circle(edge, other, &expected);
+      if (i % 2 == 0) num_touching += collided;
+      if (!collided) continue;
+      assert(hits[k++] == i);
+      if (expected.b_in_a) assert(inside[m++] == i);
+    }
+    assert(k == num_hits && m == num_inside);
+    assert(num_touching > 0 && num_touching < 50);
+    assert(num_inside > 0 && num_inside < 49);
+    satc_circle_set_destroy(set);
+    satc_circle_destroy(edge);
+  }
+
+  // One set against another, and a set against itself.
+  size_t max_pairs = 300 * 300;
+  satc_pair_t *pairs = malloc(sizeof(satc_pair_t) * max_pairs);
+  SATC_REAL *pair_x = malloc(sizeof(SATC_REAL) * max_pairs);
+  SATC_REAL *pair_y = malloc(sizeof(SATC_REAL) * max_pairs);
+  satc_points_t pair_v = { pair_x, pair_y };
+  bool *seen = calloc(300 * 300, sizeof(bool));
+  satc_circle_t *first = satc_circle_create(circle_pos, 1.0);
+  satc_circle_set_t *sets[2] = { b, a };
+  size_t s = 0;
+  for (; s < 2; s++) {
+    satc_circle_set_t *set = sets[s];
+    size_t num_pairs = satc_test_circle_sets(a, set, max_pairs, pairs, &pair_v);
+    for (k = 0; k < num_pairs; k++) {
+      if (set == a) assert(pairs[k].a < pairs[k].b);
+      assert(!seen[pairs[k].a * 300 + pairs[k].b]);
+      seen[pairs[k].a * 300 + pairs[k].b] = true;
+      satc_point_set_xy(first->pos, a->x[pairs[k].a], a->y[pairs[k].a]);
+      first->r = a->r[pairs[k].a];
+      satc_point_set_xy(other->pos, set->x[pairs[k].b], set->y[pairs[k].b]);
+      other->r = set->r[pairs[k].b];
+      assert(satc_test_circle_circle(first, other, &expected));
+      satc_assert_near(pair_x[k], expected.overlap_v[0]);
+      satc_assert_near(pair_y[k], expected.overlap_v[1]);
+    }
+    // Every pair which overlaps was found.
+    size_t num_expected = 0;
+    for (i = 0; i < a->count; i++) {
+      size_t j = set == a ? i + 1 : 0;
+      for (; j < set->count; j++) {
+        satc_point_set_xy(first->pos, a->x[i], a->y[i]);
+        first->r = a->r[i];
+        satc_point_set_xy(other->pos, set->x[j], set->y[j]);
+        other->r = set->r[j];
+        bool collided = satc_test_circle_circle(first, other, NULL);
+        assert(seen[i * 300 + j] == collided);
+        seen[i * 300 + j] = false;
+        num_expected += collided;
+      }
+    }
+    assert(num_pairs == num_expected && num_pairs > 0);
+    // Pairs past the end of the array are counted, but not stored.
+    pairs[3].a = SIZE_MAX;
+    assert(satc_test_circle_sets(a, set, 3, pairs, NULL) == num_pairs);
+    assert(pairs[3].a == SIZE_MAX);
+  }
+
+  free(seen);
+  free(pair_y);
+  free(pair_x);
+  free(pairs);
+  satc_circle_destroy(first);
+  satc_circle_destroy(other);
+  satc_circle_destroy(circle);
+  satc_circle_set_destroy(b);
+  satc_circle_set_destroy(a);
+}
+
+void satc_range_overlap_test () {
+  // A starts and ends before B, so A is pulled back by how far its end reaches into B.
+  SATC_REAL range_a[2] = { 0.0, 10.0 };
+  SATC_REAL range_b[2] = { 8.0, 20.0 };
+  satc_response_t response = SATC_RESPONSE_INIT;
+  satc_assert_near(_satc_range_overlap(range_a, range_b, &response), 2.0);
+  assert(!response.a_in_b);
+  assert(!response.b_in_a);
+  // And the other way around.
+  response = (satc_response_t) SATC_RESPONSE_INIT;
+  satc_assert_near(_satc_range_overlap(range_b, range_a, &response), -2.0);
+  assert(!response.a_in_b);
+  assert(!response.b_in_a);
+}
+
+void satc_response_test () {
+  {
+    // Responses can live on the stack.
+    satc_response_t response = SATC_RESPONSE_INIT;
+    assert(response.a == NULL);
+    assert(response.overlap == SATC_REAL_MAX);
+    assert(response.a_in_b);
+    assert(response.b_in_a);
+
+    satc_point_alloca_xy(c1_pos, 0.0, 0.0);
+    satc_point_alloca_xy(c2_pos, 30.0, 0.0);
+    satc_circle_t *circle_1 = satc_circle_create(c1_pos, 20.0);
+    satc_circle_t *circle_2 = satc_circle_create(c2_pos, 20.0);
+    assert(satc_test_circle_circle(circle_1, circle_2, &response));
+    satc_assert_near(response.overlap, 10.0);
+    satc_assert_near(satc_point_get_x(response.overlap_v), 10.0);
+
+    satc_response_clear(&response);
+    assert(response.a == NULL);
+    assert(response.overlap == SATC_REAL_MAX);
+    assert(satc_point_get_x(response.overlap_v) == 0.0);
+    satc_circle_destroy(circle_2);
+    satc_circle_destroy(circle_1);
+  }
+
+  {
+    // Responses can be packed into contiguous arrays.
+    satc_response_t responses[3];
+    satc_response_init_array(3, responses);
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_circle_t *circle = satc_circle_create(pos, 10.0);
+    size_t i = 0;
+    for (; i < 3; i++) {
+      assert(responses[i].overlap == SATC_REAL_MAX);
+      satc_point_alloca_xy(other_pos, 5.0 * i, 0.0);
+      satc_circle_t *other = satc_circle_create(other_pos, 10.0);
+      assert(satc_test_circle_circle(circle, other, &responses[i]));
+      satc_circle_destroy(other);
+    }
+
+    satc_assert_near(responses[0].overlap, 20.0);
+    satc_assert_near(responses[1].overlap, 15.0);
+    satc_assert_near(responses[2].overlap, 10.0);
+    satc_circle_destroy(circle);
+  }
+}
+
+void satc_alloc_stats_test () {
+  {
+    // Shapes count their allocations by category.
+    satc_alloc_stats_reset();
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    satc_box_t *box = satc_box_create(pos, 20.0, 20.0);
+    satc_polygon_t *polygon = satc_box_to_polygon(box);
+    satc_circle_t *circle = satc_circle_create(pos, 20.0);
+    satc_response_t *response = satc_response_create();
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_BOX] == 1);
+    // Box polygons are small polygons, so they are a single allocation.
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_POLYGON] == 1);
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_CIRCLE] == 1);
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_RESPONSE] == 1);
+    assert(satc_alloc_stats_total() == 4);
+
+    // Hot paths never touch the heap.
+    satc_point_alloca_xy(point, 10.0, 10.0);
+    assert(satc_test_polygon_polygon(polygon, polygon, response));
+    assert(satc_test_polygon_circle(polygon, circle, response));
+    assert(satc_test_circle_polygon(circle, polygon, response));
+    assert(satc_test_circle_circle(circle, circle, response));
+    assert(satc_point_in_polygon(point, polygon));
+    assert(satc_point_in_circle(point, circle));
+    assert(satc_alloc_stats_total() == 4);
+
+    // Replacing points with no more than the capacity never touches the heap.
+    satc_point_array_alloca(points, 3);
+    points[0] = pos;
+    points[1] = point;
+    points[2] = pos;
+    satc_polygon_set_points(polygon, 3, points);
+    assert(satc_alloc_stats_total() == 4);
+
+    satc_response_destroy(response);
+    satc_circle_destroy(circle);
+    satc_polygon_destroy(polygon);
+    satc_box_destroy(box);
+    assert(satc_alloc_stats.frees[SATC_ALLOC_BOX] == 1);
+    assert(satc_alloc_stats.frees[SATC_ALLOC_POLYGON] == 1);
+    assert(satc_alloc_stats.frees[SATC_ALLOC_CIRCLE] == 1);
+    assert(satc_alloc_stats.frees[SATC_ALLOC_RESPONSE] == 1);
+  }
+
+  {
+    // Heap arenas are counted as scratch memory, and what they hand out is not.
+    satc_alloc_stats_reset();
+    satc_arena_t *arena = satc_arena_create(1024);
+    satc_point_alloca_xy(pos, 0.0, 0.0);
+    assert(satc_circle_create_in(arena, pos, 1.0) != NULL);
+    assert(satc_alloc_stats.allocs[SATC_ALLOC_SCRATCH] == 1);
+    assert(satc_alloc_stats_total() == 1);
+    satc_arena_destroy(arena);
+    assert(satc_alloc_stats.frees[SATC_ALLOC_SCRATCH] == 1);
+  }
+}
+
 int main (int argc, char *argv[], char *envp[]) {
   satc_point_scale_xy_test();
+  satc_vec2_test();
   satc_polygon_get_centroid_test();
   satc_collision_test();
   satc_point_test();
+  satc_point_in_polygon_matches_reference_test();
   satc_polygon_transform_test();
+  satc_polygon_update_batch_test();
+  satc_geometry_test();
+  satc_polygon_view_test();
+  satc_small_polygon_test();
+  satc_normal_twins_test();
+  satc_normal_extents_test();
+  satc_axis_batch_test();
+  satc_polygon_circle_kernel_test();
+  satc_hull_search_test();
+  satc_gjk_test();
+  satc_axis_cache_test();
+  satc_test_many_test();
+  satc_test_pairs_test();
+  satc_circle_set_test();
+  satc_transform_test();
+  satc_test_polygon_polygon_local_test();
+  satc_arena_test();
+  satc_range_overlap_test();
+  satc_response_test();
+  satc_aabb_test();
+
+  // Every test deallocates whatever it allocates.
+  size_t i = 0;
+  for (; i < SATC_ALLOC_NUM_CATEGORIES; i++) {
+    assert(satc_alloc_stats.allocs[i] == satc_alloc_stats.frees[i]);
+  }
+
+  satc_alloc_stats_test();
   return EXIT_SUCCESS;
 }
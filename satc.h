@@ -10,73 +10,590 @@
 #include "stdbool.h"
 #include "math.h"
 #include "float.h"
+#include "stdint.h"
+#include "string.h"
+
+// -----------------
+// Allocation hooks.
+// -----------------
+
+#ifndef SATC_MALLOC
+/**
+ * Allocates heap memory for the library. Define it before including `satc.h`
+ * to plug in your own allocator. `category` is one of the `SATC_ALLOC_*`
+ * values, which can be used to tag the allocation.
+ */
+#define SATC_MALLOC(size, category) malloc(size)
+#endif
+
+#ifndef SATC_FREE
+/**
+ * Deallocates heap memory for the library. Define it before including
+ * `satc.h` to plug in your own allocator. `category` is one of the
+ * `SATC_ALLOC_*` values, which can be used to tag the allocation.
+ */
+#define SATC_FREE(memory, category) free(memory)
+#endif
+
+/** Denotes an allocation of an array of doubles (a point). */
+#define SATC_ALLOC_POINT 0
+/** Denotes an allocation of a circle. */
+#define SATC_ALLOC_CIRCLE 1
+/** Denotes an allocation of a polygon, or of a polygon's storage. */
+#define SATC_ALLOC_POLYGON 2
+/** Denotes an allocation of a box. */
+#define SATC_ALLOC_BOX 3
+/** Denotes an allocation of a collision response. */
+#define SATC_ALLOC_RESPONSE 4
+/** Denotes an allocation of scratch memory, such as the block behind an arena. */
+#define SATC_ALLOC_SCRATCH 5
+/** Denotes an allocation of shared polygon geometry, or of its storage. */
+#define SATC_ALLOC_GEOMETRY 6
+/** The number of `SATC_ALLOC_*` categories. */
+#define SATC_ALLOC_NUM_CATEGORIES 7
+
+// ------------
+// Scalar type.
+// ------------
+
+#ifdef SATC_USE_FLOAT
+/**
+ * The scalar type used by every struct and function in the library.
+ *
+ * It is `double` by default. Define `SATC_USE_FLOAT` before including
+ * `satc.h` to make it `float` instead. Wherever the docs talk about doubles,
+ * they mean values of this type.
+ */
+#define SATC_REAL float
+/** The largest finite value of `SATC_REAL`. */
+#define SATC_REAL_MAX FLT_MAX
+/** The machine epsilon of `SATC_REAL`. */
+#define SATC_REAL_EPSILON FLT_EPSILON
+/** The square root function for `SATC_REAL`. */
+#define SATC_SQRT(x) sqrtf(x)
+/** The cosine function for `SATC_REAL`. */
+#define SATC_COS(x) cosf(x)
+/** The sine function for `SATC_REAL`. */
+#define SATC_SIN(x) sinf(x)
+/** The absolute value function for `SATC_REAL`. */
+#define SATC_FABS(x) fabsf(x)
+#else
+/**
+ * The scalar type used by every struct and function in the library.
+ *
+ * It is `double` by default. Define `SATC_USE_FLOAT` before including
+ * `satc.h` to make it `float` instead. Wherever the docs talk about doubles,
+ * they mean values of this type.
+ */
+#define SATC_REAL double
+/** The largest finite value of `SATC_REAL`. */
+#define SATC_REAL_MAX DBL_MAX
+/** The machine epsilon of `SATC_REAL`. */
+#define SATC_REAL_EPSILON DBL_EPSILON
+/** The square root function for `SATC_REAL`. */
+#define SATC_SQRT(x) sqrt(x)
+/** The cosine function for `SATC_REAL`. */
+#define SATC_COS(x) cos(x)
+/** The sine function for `SATC_REAL`. */
+#define SATC_SIN(x) sin(x)
+/** The absolute value function for `SATC_REAL`. */
+#define SATC_FABS(x) fabs(x)
+#endif
+
+// -----
+// SIMD.
+// -----
+
+// A thin layer over SSE2 and AVX, so the hot loops over structure-of-arrays
+// points can be written once for both scalar types. It is used automatically
+// when the compiler targets SSE2 or AVX (for instance with `-mavx`), and can
+// be turned off by defining `SATC_NO_SIMD` before including `satc.h`. Every
+// function using it falls back to plain loops for the leftover points, and
+// produces the same results either way.
+//
+// `satc_simd_t` holds `SATC_SIMD_WIDTH` values of `SATC_REAL`. Loads and
+// stores are unaligned. Comparisons return masks for `satc_simd_select`,
+// `satc_simd_any`, and `satc_simd_bits`, which packs them into an int with
+// one bit per lane.
+//
+// The instruction set is picked at compile time. AVX2 adds nothing over AVX
+// for these kernels, and other targets (such as NEON) use the plain loops.
+
+#if !defined(SATC_NO_SIMD) && (defined(__AVX__) || defined(__SSE2__))
+#include <immintrin.h>
+/** Defined when the SIMD layer is available. */
+#define SATC_SIMD 1
+#if defined(__AVX__) && defined(SATC_USE_FLOAT)
+#define satc_simd_t __m256
+#define SATC_SIMD_WIDTH 8
+#define satc_simd_load(p) _mm256_loadu_ps(p)
+#define satc_simd_store(p, a) _mm256_storeu_ps((p), (a))
+#define satc_simd_set1(x) _mm256_set1_ps(x)
+#define satc_simd_add(a, b) _mm256_add_ps((a), (b))
+#define satc_simd_sub(a, b) _mm256_sub_ps((a), (b))
+#define satc_simd_mul(a, b) _mm256_mul_ps((a), (b))
+#define satc_simd_div(a, b) _mm256_div_ps((a), (b))
+#define satc_simd_sqrt(a) _mm256_sqrt_ps(a)
+#define satc_simd_min(a, b) _mm256_min_ps((a), (b))
+#define satc_simd_max(a, b) _mm256_max_ps((a), (b))
+#define satc_simd_gt(a, b) _mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define satc_simd_and(a, b) _mm256_and_ps((a), (b))
+#define satc_simd_andnot(a, b) _mm256_andnot_ps((a), (b))
+#define satc_simd_or(a, b) _mm256_or_ps((a), (b))
+#define satc_simd_xor(a, b) _mm256_xor_ps((a), (b))
+#define satc_simd_any(mask) (_mm256_movemask_ps(mask) != 0)
+#define satc_simd_bits(mask) _mm256_movemask_ps(mask)
+#elif defined(__AVX__)
+#define satc_simd_t __m256d
+#define SATC_SIMD_WIDTH 4
+#define satc_simd_load(p) _mm256_loadu_pd(p)
+#define satc_simd_store(p, a) _mm256_storeu_pd((p), (a))
+#define satc_simd_set1(x) _mm256_set1_pd(x)
+#define satc_simd_add(a, b) _mm256_add_pd((a), (b))
+#define satc_simd_sub(a, b) _mm256_sub_pd((a), (b))
+#define satc_simd_mul(a, b) _mm256_mul_pd((a), (b))
+#define satc_simd_div(a, b) _mm256_div_pd((a), (b))
+#define satc_simd_sqrt(a) _mm256_sqrt_pd(a)
+#define satc_simd_min(a, b) _mm256_min_pd((a), (b))
+#define satc_simd_max(a, b) _mm256_max_pd((a), (b))
+#define satc_simd_gt(a, b) _mm256_cmp_pd((a), (b), _CMP_GT_OQ)
+#define satc_simd_and(a, b) _mm256_and_pd((a), (b))
+#define satc_simd_andnot(a, b) _mm256_andnot_pd((a), (b))
+#define satc_simd_or(a, b) _mm256_or_pd((a), (b))
+#define satc_simd_xor(a, b) _mm256_xor_pd((a), (b))
+#define satc_simd_any(mask) (_mm256_movemask_pd(mask) != 0)
+#define satc_simd_bits(mask) _mm256_movemask_pd(mask)
+#elif defined(SATC_USE_FLOAT)
+#define satc_simd_t __m128
+#define SATC_SIMD_WIDTH 4
+#define satc_simd_load(p) _mm_loadu_ps(p)
+#define satc_simd_store(p, a) _mm_storeu_ps((p), (a))
+#define satc_simd_set1(x) _mm_set1_ps(x)
+#define satc_simd_add(a, b) _mm_add_ps((a), (b))
+#define satc_simd_sub(a, b) _mm_sub_ps((a), (b))
+#define satc_simd_mul(a, b) _mm_mul_ps((a), (b))
+#define satc_simd_div(a, b) _mm_div_ps((a), (b))
+#define satc_simd_sqrt(a) _mm_sqrt_ps(a)
+#define satc_simd_min(a, b) _mm_min_ps((a), (b))
+#define satc_simd_max(a, b) _mm_max_ps((a), (b))
+#define satc_simd_gt(a, b) _mm_cmpgt_ps((a), (b))
+#define satc_simd_and(a, b) _mm_and_ps((a), (b))
+#define satc_simd_andnot(a, b) _mm_andnot_ps((a), (b))
+#define satc_simd_or(a, b) _mm_or_ps((a), (b))
+#define satc_simd_xor(a, b) _mm_xor_ps((a), (b))
+#define satc_simd_any(mask) (_mm_movemask_ps(mask) != 0)
+#define satc_simd_bits(mask) _mm_movemask_ps(mask)
+#else
+#define satc_simd_t __m128d
+#define SATC_SIMD_WIDTH 2
+#define satc_simd_load(p) _mm_loadu_pd(p)
+#define satc_simd_store(p, a) _mm_storeu_pd((p), (a))
+#define satc_simd_set1(x) _mm_set1_pd(x)
+#define satc_simd_add(a, b) _mm_add_pd((a), (b))
+#define satc_simd_sub(a, b) _mm_sub_pd((a), (b))
+#define satc_simd_mul(a, b) _mm_mul_pd((a), (b))
+#define satc_simd_div(a, b) _mm_div_pd((a), (b))
+#define satc_simd_sqrt(a) _mm_sqrt_pd(a)
+#define satc_simd_min(a, b) _mm_min_pd((a), (b))
+#define satc_simd_max(a, b) _mm_max_pd((a), (b))
+#define satc_simd_gt(a, b) _mm_cmpgt_pd((a), (b))
+#define satc_simd_and(a, b) _mm_and_pd((a), (b))
+#define satc_simd_andnot(a, b) _mm_andnot_pd((a), (b))
+#define satc_simd_or(a, b) _mm_or_pd((a), (b))
+#define satc_simd_xor(a, b) _mm_xor_pd((a), (b))
+#define satc_simd_any(mask) (_mm_movemask_pd(mask) != 0)
+#define satc_simd_bits(mask) _mm_movemask_pd(mask)
+#endif
+/** Picks lanes from `a` where `mask` is set, and from `b` elsewhere. */
+#define satc_simd_select(mask, a, b) satc_simd_or(satc_simd_and((mask), (a)), satc_simd_andnot((mask), (b)))
+/** Flips the sign of every lane, like unary minus. */
+#define satc_simd_neg(a) satc_simd_xor((a), satc_simd_set1(-0.0))
+#endif
+
+// Two axes at a time (SSE2 with doubles) is too few to pay for gathering
+// them, so only wider vectors project onto batches of axes.
+#if defined(SATC_SIMD) && SATC_SIMD_WIDTH >= 4
+#define SATC_SIMD_AXES
+/** The number of axes `satc_test_polygon_polygon` projects onto at once. */
+#define SATC_AXIS_BATCH SATC_SIMD_WIDTH
+#else
+#define SATC_AXIS_BATCH 4
+#endif
+
+// ----------------------
+// Contracted arithmetic.
+// ----------------------
+
+// The SIMD kernels and their plain loops have to round the same way, or a
+// point, edge, or distance can come out differently depending on where it
+// falls in the array. Compilers targeting FMA (for instance with
+// `-march=native`) may fuse a multiply and an add into one instruction in
+// one loop but not the other, so fusing is turned off for the rest of this
+// header, and turned back on at its end.
+
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize ("fp-contract=off")
+#endif
 
 // -------------------------------------
 // Forward declarations for the structs.
 // -------------------------------------
 
+#ifndef SATC_SMALL_POLYGON_CAPACITY
+/**
+ * The number of points a `satc_small_polygon_t` can hold inline. Define it
+ * before including `satc.h` to change it.
+ */
+#define SATC_SMALL_POLYGON_CAPACITY 8
+#endif
+
+#ifndef SATC_HULL_SEARCH_MIN_POINTS
+/**
+ * The number of points from which a convex polygon is projected onto an
+ * axis by searching its normals, rather than by projecting every point.
+ * Define it before including `satc.h` to change it.
+ */
+#define SATC_HULL_SEARCH_MIN_POINTS 128
+#endif
+
+#ifndef SATC_GJK_SEARCH_MIN_POINTS
+/**
+ * The number of points from which GJK finds a convex polygon's furthest
+ * point along a direction by searching its normals, rather than by walking
+ * every point. Define it before including `satc.h` to change it.
+ */
+#define SATC_GJK_SEARCH_MIN_POINTS 24
+#endif
+
+#ifndef SATC_GJK_MAX_ITERATIONS
+/**
+ * The most steps GJK and EPA take before settling for the closest answer
+ * found so far. Define it before including `satc.h` to change it.
+ */
+#define SATC_GJK_MAX_ITERATIONS 64
+#endif
+
+#ifndef SATC_PAIR_BATCH
+/**
+ * The number of pairs `satc_test_pairs` sorts by the types of their shapes
+ * at a time, on the stack. Define it before including `satc.h` to change it.
+ */
+#define SATC_PAIR_BATCH 256
+#endif
+
+#ifndef SATC_CIRCLE_SET_BLOCK
+/**
+ * The number of circles of each set `satc_test_circle_sets` works through at
+ * a time, so that a block of one set is tested against a block of the other
+ * while both are in cache. Define it before including `satc.h` to change it.
+ */
+#define SATC_CIRCLE_SET_BLOCK 256
+#endif
+
+/** The alignment, in bytes, of every block handed out by an arena. */
+#define SATC_ARENA_ALIGNMENT 16
+
+/**
+ * The number of `SATC_REAL` values it takes to hold `count` indices, when
+ * they are stored at the end of a block of them.
+ */
+#define _satc_index_reals(count) (((count) * sizeof(size_t) + sizeof(SATC_REAL) - 1) / sizeof(SATC_REAL))
+
+/**
+ * The number of doubles in a polygon's storage block with room for `capacity`
+ * points: twelve arrays of `capacity` doubles, followed by `capacity` indices.
+ */
+#define _satc_polygon_storage_reals(capacity) ((capacity) * 12 + _satc_index_reals(capacity))
+
 /** The type of a circle struct. */
 typedef struct satc_circle satc_circle_t;
+/** The type of a packed set of circles. */
+typedef struct satc_circle_set satc_circle_set_t;
+/** The type of a 2D vector value. */
+typedef struct satc_vec2 satc_vec2_t;
+/** The type of an axis-aligned bounding box. */
+typedef struct satc_aabb satc_aabb_t;
+/** The type of a rigid transform struct. */
+typedef struct satc_transform satc_transform_t;
+/** The type of a structure of arrays of points. */
+typedef struct satc_points satc_points_t;
+/** The type of a shared polygon geometry struct. */
+typedef struct satc_geometry satc_geometry_t;
 /** The type of a polygon struct. */
 typedef struct satc_polygon satc_polygon_t;
+/** The type of a polygon struct with inline storage. */
+typedef struct satc_small_polygon satc_small_polygon_t;
 /** The type of a box struct. */
 typedef struct satc_box satc_box_t;
 /** The type of a response struct. */
 typedef struct satc_response satc_response_t;
+/** The type of a separating axis cache struct. */
+typedef struct satc_axis_cache satc_axis_cache_t;
+/** The type of a pair of shape indices. */
+typedef struct satc_pair satc_pair_t;
+/** The type of a structure of arrays of pair results. */
+typedef struct satc_pair_results satc_pair_results_t;
+/** The type of an arena struct. */
+typedef struct satc_arena satc_arena_t;
+/** The type of an allocation counters struct. */
+typedef struct satc_alloc_stats satc_alloc_stats_t;
+
+/**
+ * A caller-owned block of memory that shapes and responses can be carved out
+ * of. Everything allocated from an arena is released at once with
+ * `satc_arena_reset`.
+ *
+ * Nothing is released before then. When a polygon in an arena outgrows its
+ * storage, such as in `satc_polygon_set_points`, it moves into a new block
+ * carved out of the same arena, and its old block stays used until the
+ * arena is reset. Leave room for that, or give polygons their largest number
+ * of points up front.
+ */
+struct satc_arena {
+  /** The caller-owned block of memory. */
+  unsigned char *base;
+  /** The size of the block of memory, in bytes. */
+  size_t size;
+  /** The number of bytes which have been handed out so far. */
+  size_t used;
+};
+
+/**
+ * Counters of heap allocations and deallocations, per `SATC_ALLOC_*`
+ * category. They are only kept when `SATC_ALLOC_STATS` is defined before
+ * including `satc.h`.
+ */
+struct satc_alloc_stats {
+  /** The number of allocations made in each category. */
+  size_t allocs[SATC_ALLOC_NUM_CATEGORIES];
+  /** The number of deallocations made in each category. */
+  size_t frees[SATC_ALLOC_NUM_CATEGORIES];
+};
 
 /** A circle shape, with a position and radius. */
 struct satc_circle {
   /** The shape type of the struct. */
   int type;
-  /** The position of the circle. */
-  double *pos;
+  /** The position of the circle, stored inline as an array of doubles (a point). */
+  SATC_REAL pos[2];
   /** The radius of the circle. */
-  double r;
+  SATC_REAL r;
+};
+
+/**
+ * A set of circles packed into a structure of arrays, for large numbers of
+ * small circles such as particles. A circle takes three values rather than
+ * a separate struct, and the whole set is a single allocation. Create one
+ * with `satc_circle_set_create`. The arrays can be written directly, as
+ * long as `count` stays within `capacity`.
+ */
+struct satc_circle_set {
+  /** The number of circles in the set. */
+  size_t count;
+  /** The number of circles the set has room for. */
+  size_t capacity;
+  /** The `x` positions of the circles. */
+  SATC_REAL *x;
+  /** The `y` positions of the circles. */
+  SATC_REAL *y;
+  /** The radii of the circles. */
+  SATC_REAL *r;
+};
+
+/**
+ * A 2D vector, passed and returned by value.
+ *
+ * Unlike an array of doubles (a point), a vector never needs to be allocated,
+ * and the `satc_vec2_*` functions never mutate their arguments.
+ */
+struct satc_vec2 {
+  /** The `x` value of the vector. */
+  SATC_REAL x;
+  /** The `y` value of the vector. */
+  SATC_REAL y;
+};
+
+/**
+ * An axis-aligned bounding box, as a minimum and maximum corner. It is a
+ * plain value, so it never needs to be allocated.
+ */
+struct satc_aabb {
+  /** The corner with the smallest `x` and `y` values, as an array of doubles (a point). */
+  SATC_REAL min[2];
+  /** The corner with the largest `x` and `y` values, as an array of doubles (a point). */
+  SATC_REAL max[2];
+};
+
+/**
+ * A rigid transform, as a position and an angle, with the cosine and sine of
+ * the angle cached so they are only calculated when the angle changes. It is
+ * a plain value, so it never needs to be allocated.
+ *
+ * Polygons can reference a shared transform with `satc_polygon_set_transform`,
+ * so that many shapes attached to one body follow it without their own trig.
+ */
+struct satc_transform {
+  /** The position of the transform, stored inline as an array of doubles (a point). */
+  SATC_REAL pos[2];
+  /**
+   * The angle of rotation of the transform.
+   *
+   * Use `satc_transform_set_angle` to change this.
+   */
+  SATC_REAL angle;
+  /**
+   * The cosine and sine of `angle`, stored inline as an array of doubles (a
+   * point).
+   *
+   * This should not be modified manually.
+   */
+  SATC_REAL rotation[2];
+  /**
+   * A counter which is bumped whenever the transform changes, so shapes
+   * referencing it can tell when they are out of date.
+   *
+   * This should not be modified manually.
+   */
+  unsigned long version;
+};
+
+/**
+ * A list of points stored as a structure of arrays, with all of the `x` values
+ * in one array and all of the `y` values in another.
+ */
+struct satc_points {
+  /** The `x` values of the points, as an array of doubles. */
+  SATC_REAL *x;
+  /** The `y` values of the points, as an array of doubles. */
+  SATC_REAL *y;
+};
+
+/**
+ * The immutable, reference-counted points of a polygon, along with their
+ * edges and normals, which can be shared by any number of polygon instances.
+ * Create instances with `satc_polygon_create_instance`.
+ */
+struct satc_geometry {
+  /** The number of points in the geometry. */
+  size_t num_points;
+  /** The points of the geometry, as a structure of arrays. */
+  satc_points_t points;
+  /** The edges between the points, as a structure of arrays. */
+  satc_points_t edges;
+  /** The unit normals of the edges, as a structure of arrays. */
+  satc_points_t normals;
+  /** For each normal, the index of its twin. See `satc_polygon_t`. */
+  size_t *normal_twins;
+  /** The number of distinct axes among the normals. */
+  size_t num_axes;
+  /** The extent of the points along each normal. See `satc_polygon_t`. */
+  satc_points_t normal_extents;
+  /** Whether the points make up a convex polygon. */
+  bool convex;
+  /** Which way the normals turn. See `satc_polygon_t`. */
+  int normal_turn;
+  /**
+   * The number of references to the geometry. It is deallocated when the
+   * last one is released.
+   *
+   * Use `satc_geometry_retain` and `satc_geometry_release` to change this.
+   */
+  size_t refs;
+  /**
+   * The single contiguous block of doubles backing `points`, `edges`,
+   * `normals`, `normal_extents`, and `normal_twins`.
+   *
+   * This should not be modified manually.
+   */
+  SATC_REAL *storage;
+  /**
+   * The arena the geometry was carved out of, or `NULL` if it was allocated
+   * on the heap.
+   *
+   * This should not be modified manually.
+   */
+  satc_arena_t *arena;
 };
 
 /** A polygon shape, with a position, angle, offset, and points. */
 struct satc_polygon {
   /** The shape type of the struct. */
   int type;
-  /** The position of the polygon. */
-  double *pos;
+  /** The position of the polygon, stored inline as an array of doubles (a point). */
+  SATC_REAL pos[2];
   /** The number of points in the polygon. */
   size_t num_points;
   /**
-   * The list of points in the polygon, as an array of arrays of doubles.
+   * The number of points the polygon's storage can hold before it needs to be
+   * reallocated.
+   *
+   * This should not be modified manually.
+   */
+  size_t capacity;
+  /**
+   * The list of points in the polygon, as a structure of arrays.
+   *
+   * Use `satc_polygon_set_points` to change this. Or, if you need to do it
+   * manually, call `satc_polygon_invalidate` afterward.
+   */
+  satc_points_t points;
+  /**
+   * The distance from one value to the next in `points.x` and `points.y`,
+   * counted in `SATC_REAL` values. It is 1 unless the polygon is a view over
+   * an interleaved buffer.
    *
-   * Use `satc_polygon_copy_points` to change this. Or, if you need to do it
-   * manually, call `_satc_polygon_recalc` afterward.
+   * This should not be modified manually.
+   */
+  size_t points_stride;
+  /**
+   * Whether `points` is borrowed, from shared geometry or from a caller-owned
+   * buffer, instead of living in `storage`. Borrowed points are never
+   * modified or deallocated by the polygon.
+   *
+   * This should not be modified manually.
    */
-  double **points;
+  bool points_borrowed;
   /**
    * The angle of rotation of the polygon.
    *
    * Use `satc_polygon_set_angle` to change this. Or, if you need to do it
-   * manually, call `_satc_polygon_recalc` afterward.
+   * manually, update `rotation` and add `SATC_POLYGON_DIRTY_CALC_POINTS` and
+   * `SATC_POLYGON_DIRTY_EDGES` to `dirty` afterward.
+   */
+  SATC_REAL angle;
+  /**
+   * The cosine and sine of `angle`, stored inline as an array of doubles (a
+   * point), so recalculating the polygon needs no trig.
+   *
+   * This should not be modified manually.
    */
-  double angle;
+  SATC_REAL rotation[2];
   /**
-   * The offset as an array of doubles (a point) of the polygon.
+   * The offset of the polygon, stored inline as an array of doubles (a point).
    *
    * Use `satc_polygon_set_offset` to change this. Or, if you need to do it
-   * manually, call `_satc_polygon_recalc` afterward.
+   * manually, add `SATC_POLYGON_DIRTY_CALC_POINTS` to `dirty` afterward.
    */
-  double *offset;
+  SATC_REAL offset[2];
   /**
    * The number of calculated points for the polygon. This will match the
-   * number of points.
+   * number of points, except for instances of a geometry, where it stays zero
+   * until the calculated points are first needed.
    *
    * This should not be modified manually.
    */
   size_t num_calc_points;
   /**
-   * An array of arrays of doubles (array of points) representing the
-   * calculated points of the polygon. This will match the number of points.
+   * A structure of arrays representing the calculated points of the polygon.
+   * This will match the number of points. It is recalculated lazily, so call
+   * `satc_polygon_update` before reading it directly.
    *
    * This should not be modified manually.
    */
-  double **calc_points;
+  satc_points_t calc_points;
   /**
    * The number of calculated edges for the polygon. This will match the
    * number of points.
@@ -85,12 +602,13 @@ struct satc_polygon {
    */
   size_t num_edges;
   /**
-   * An array of arrays of doubles (array of points) representing the
-   * calculated edges of the polygon. This will match the number of points.
+   * A structure of arrays representing the calculated edges of the polygon.
+   * This will match the number of points. It is recalculated lazily, so call
+   * `satc_polygon_update` before reading it directly.
    *
    * This should not be modified manually.
    */
-  double **edges;
+  satc_points_t edges;
   /**
    * The number of calculated normals for the polygon. This will match the
    * number of points.
@@ -99,51 +617,263 @@ struct satc_polygon {
    */
   size_t num_normals;
   /**
-   * An array of arrays of doubles (array of points) representing the
-   * calculated normals of the polygon. This will match the number of points.
+   * A structure of arrays representing the calculated normals of the polygon.
+   * This will match the number of points. It is recalculated lazily, so call
+   * `satc_polygon_update` before reading it directly.
+   *
+   * This should not be modified manually.
+   */
+  satc_points_t normals;
+  /**
+   * A structure of arrays representing the normals of the untransformed
+   * `points`, before the offset and angle are applied. They only change when
+   * the points do, and are used by `satc_test_polygon_polygon_local`.
+   *
+   * This should not be modified manually.
+   */
+  satc_points_t local_normals;
+  /**
+   * For each normal, the index of its twin: the normal lying along the same
+   * axis but facing the other way, like the opposite side of a box. A normal
+   * without a twin holds its own index. Projecting onto one of a pair of twins
+   * gives the projection onto the other for free, so each axis is only
+   * projected onto once. Rotation does not change the twins, so they are
+   * found along with `local_normals`.
+   *
+   * This should not be modified manually.
+   */
+  size_t *normal_twins;
+  /**
+   * The number of distinct axes among the normals, which is the number of
+   * normals minus the number of pairs of twins.
+   *
+   * This should not be modified manually.
+   */
+  size_t num_axes;
+  /**
+   * The smallest (`x`) and largest (`y`) projections of the untransformed
+   * `points` onto each of the `local_normals`. Rotating a polygon rotates its
+   * points and normals together, so adding the projection of the offset gives
+   * the polygon's own range along each of its normals, and a test against
+   * the polygon's axes only has to project the other shape.
+   *
+   * This should not be modified manually.
+   */
+  satc_points_t normal_extents;
+  /**
+   * Whether the untransformed points make up a convex polygon. Found along
+   * with `local_normals`.
+   *
+   * This should not be modified manually.
+   */
+  bool convex;
+  /**
+   * Which way the normals turn as they go around a convex polygon: `1` for
+   * counter-clockwise, which makes them face outwards, or `-1` for
+   * clockwise. The normals are then sorted by angle, so the ends of the
+   * polygon's range along any axis can be found by a binary search. It is
+   * `0` if they can not be searched, because the polygon is concave, or has
+   * an edge of zero length.
+   *
+   * This should not be modified manually.
+   */
+  int normal_turn;
+  /**
+   * The bounding box of the calculated points, relative to `pos`. It is kept
+   * up to date by `satc_polygon_update`. Use `satc_polygon_get_bounds` to get
+   * the bounding box in world space.
+   *
+   * This should not be modified manually.
+   */
+  satc_aabb_t aabb;
+  /**
+   * A combination of `SATC_POLYGON_DIRTY_*` flags, marking which calculated
+   * values are out of date. They are brought up to date by
+   * `satc_polygon_update`, which every function reading them calls first.
+   *
+   * This should not be modified manually.
+   */
+  int dirty;
+  /**
+   * The shared transform the polygon follows, or `NULL` if it has none. While
+   * set, the transform's position and angle replace the polygon's own.
+   *
+   * Use `satc_polygon_set_transform` to change this.
+   */
+  satc_transform_t *transform;
+  /**
+   * The version of `transform` which the polygon last copied its position and
+   * angle from.
+   *
+   * This should not be modified manually.
+   */
+  unsigned long transform_version;
+  /**
+   * The shared geometry the polygon is an instance of, or `NULL` if the
+   * polygon owns its points. Instances borrow `points`, `local_normals`,
+   * `normal_twins`, and `normal_extents` from the geometry, and only allocate
+   * their calculated values the first time those are needed.
+   *
+   * This should not be modified manually.
+   */
+  satc_geometry_t *geometry;
+  /**
+   * The single contiguous block of doubles backing `points`, `calc_points`,
+   * `edges`, `normals`, `local_normals`, `normal_extents`, and
+   * `normal_twins`. It holds twelve arrays of `capacity` doubles each,
+   * followed by `capacity` indices.
+   *
+   * This should not be modified manually.
+   */
+  SATC_REAL *storage;
+  /**
+   * Whether `storage` lives inside of a `satc_small_polygon_t` along with the
+   * polygon, rather than in an allocation of its own.
+   *
+   * This should not be modified manually.
+   */
+  bool storage_inline;
+  /**
+   * Whether the polygon struct itself lives on the stack or inside of some
+   * other struct, so `satc_polygon_destroy` must not deallocate it.
+   *
+   * This should not be modified manually.
+   */
+  bool embedded;
+  /**
+   * The arena the polygon and its storage were carved out of, or `NULL` if
+   * they were allocated on the heap.
    *
    * This should not be modified manually.
    */
-  double **normals;
+  satc_arena_t *arena;
+};
+
+/**
+ * A polygon with room for up to `SATC_SMALL_POLYGON_CAPACITY` points stored
+ * inline, along with their calculated values, so the whole shape is a single
+ * block of memory. It can live on the stack (see `satc_small_polygon_init`)
+ * or in one allocation (see `satc_small_polygon_create`).
+ *
+ * Pass `&small->polygon` (or the pointer returned when it was set up) to any
+ * function taking a polygon. Since the polygon points into its own storage,
+ * the struct must not be copied or moved once it is set up.
+ */
+struct satc_small_polygon {
+  /** The polygon itself. */
+  satc_polygon_t polygon;
+  /** Padding, so the storage is as aligned as the small polygon itself. */
+  unsigned char padding[SATC_ARENA_ALIGNMENT - sizeof(satc_polygon_t) % SATC_ARENA_ALIGNMENT];
+  /** The inline storage backing the polygon, with room for `SATC_SMALL_POLYGON_CAPACITY` points. */
+  SATC_REAL storage[_satc_polygon_storage_reals(SATC_SMALL_POLYGON_CAPACITY)];
 };
 
 /** A box shape, with a position, width, and height. */
 struct satc_box {
   /** The shape type of the struct. */
   int type;
-  /** The position of the box. */
-  double *pos;
+  /** The position of the box, stored inline as an array of doubles (a point). */
+  SATC_REAL pos[2];
   /** The width of the box. */
-  double w;
+  SATC_REAL w;
   /** The height of the box. */
-  double h;
+  SATC_REAL h;
 };
 
-/** A response, representing an overlap between two shapes. */
+/**
+ * A response, representing an overlap between two shapes.
+ *
+ * A response owns no memory of its own, so it can be declared on the stack or
+ * packed into arrays. See `satc_response_init` and `SATC_RESPONSE_INIT`.
+ */
 struct satc_response {
   /** The first shape participating in the collision. */
   void *a;
   /** The second shape participating in the collision. */
   void *b;
   /** The length of overlap of the collision. */
-  double overlap;
-  /** The unit vector of the overlap of the collision. */
-  double *overlap_n;
+  SATC_REAL overlap;
+  /**
+   * The unit vector of the overlap of the collision, stored inline as an array
+   * of doubles (a point).
+   */
+  SATC_REAL overlap_n[2];
   /**
    * The unit vector of the overlap of the collision, scaled by the length of
-   * overlap.
+   * overlap, stored inline as an array of doubles (a point).
    */
-  double *overlap_v;
+  SATC_REAL overlap_v[2];
   /** True if shape `a` is entirely within shape `b`. */
   bool a_in_b;
   /** True if shape `b` is entirely within shape `a`. */
   bool b_in_a;
 };
 
+/**
+ * Remembers which axis last separated a pair of polygons, or gave their
+ * overlap, so that `satc_test_polygon_polygon_cached` can try it first the
+ * next time the pair is tested. Keep one for each pair of polygons, such as
+ * in your own record of the pair, and start it with `SATC_AXIS_CACHE_INIT`.
+ */
+struct satc_axis_cache {
+  /**
+   * The place of the axis among the normals of both polygons, counting the
+   * first polygon's normals and then the second's, or `SIZE_MAX` if there is
+   * none yet.
+   */
+  size_t place;
+};
+
+/**
+ * A pair of shapes to test with `satc_test_pairs`, as indices into an array
+ * of shapes, such as a pair found by a broadphase.
+ */
+struct satc_pair {
+  /** The index of the first shape, which is `a` in its response. */
+  size_t a;
+  /** The index of the second shape, which is `b` in its response. */
+  size_t b;
+};
+
+/**
+ * The results of `satc_test_pairs`, as a structure of arrays with one entry
+ * for each pair. Only `hit` is required; leave the other arrays `NULL` to
+ * skip them, or all of them `NULL` to skip working out the responses. Pairs
+ * which do not overlap get an overlap of zero, a zero normal, and false
+ * flags.
+ */
+struct satc_pair_results {
+  /** Whether each pair overlaps. */
+  bool *hit;
+  /** The overlap of each pair, as in `satc_response_t`, or `NULL`. */
+  SATC_REAL *overlap;
+  /** The overlap normal of each pair, or `NULL` arrays. */
+  satc_points_t overlap_n;
+  /** Whether the first shape of each pair is inside the second, or `NULL`. */
+  bool *a_in_b;
+  /** Whether the second shape of each pair is inside the first, or `NULL`. */
+  bool *b_in_a;
+};
+
 // ------
 // Macros
 // ------
 
+/**
+ * An initializer for a collision response declared on the stack, inside of
+ * some other struct, or in an array. It is equivalent to `satc_response_init`.
+ *
+ * For example, `satc_response_t response = SATC_RESPONSE_INIT;`.
+ */
+#define SATC_RESPONSE_INIT { NULL, NULL, SATC_REAL_MAX, { 0.0, 0.0 }, { 0.0, 0.0 }, true, true }
+
+/**
+ * An initializer for a separating axis cache, which has no axis to try yet.
+ *
+ * For example, `satc_axis_cache_t cache = SATC_AXIS_CACHE_INIT;`.
+ */
+#define SATC_AXIS_CACHE_INIT { SIZE_MAX }
+
 /** Denotes an undefined type in a struct with a `type` field. */
 #define satc_type_none 0
 /** Denotes a circle type in a struct with a `type` field. */
@@ -153,6 +883,36 @@ struct satc_response {
 /** Denotes a box type in a struct with a `type` field. */
 #define satc_type_box 3
 
+/** Selects the separating axis test in `satc_test_shapes`. */
+#define satc_narrowphase_sat 0
+/** Selects GJK, with EPA for the overlap, in `satc_test_shapes`. */
+#define satc_narrowphase_gjk 1
+
+/**
+ * Marks a polygon's calculated points and bounding box as out of date, such
+ * as after a translation.
+ */
+#define SATC_POLYGON_DIRTY_CALC_POINTS 1
+/**
+ * Marks a polygon's calculated edges and normals as out of date, such as
+ * after a rotation.
+ */
+#define SATC_POLYGON_DIRTY_EDGES 2
+/**
+ * Marks a polygon's local normals as out of date, such as after its points
+ * are replaced.
+ */
+#define SATC_POLYGON_DIRTY_LOCAL_NORMALS 4
+
+/**
+ * An initializer for a transform at the origin, with no rotation.
+ *
+ * ```
+ * satc_transform_t transform = SATC_TRANSFORM_INIT;
+ * ```
+ */
+#define SATC_TRANSFORM_INIT { { 0.0, 0.0 }, 0.0, { 1.0, 0.0 }, 0 }
+
 /** Given a struct, returns an int representing the type.. */
 #define satc_shape_get_type(s) s->type;
 
@@ -169,6 +929,20 @@ struct satc_response {
   double *name = NULL; \
   name = (double *) alloca(sizeof(double) * size);
 
+/**
+ * Creates an array of `SATC_REAL` values, with undefined values. Since it uses
+ * `alloca`, the array will automatically be deallocated when it falls out of
+ * scope.
+ *
+ * This macro is considered a statement.
+ *
+ * @param name the variable name for the array.
+ * @param size the number of values in the array.
+ */
+#define satc_real_array_alloca(name, size) \
+  SATC_REAL *name = NULL; \
+  name = (SATC_REAL *) alloca(sizeof(SATC_REAL) * size);
+
 /**
  * Creates an array of pointers to `double *` (a point), with undefined,
  * not-yet-allocated pointer values.
@@ -185,8 +959,8 @@ struct satc_response {
  * @param size the number of pointers to points in the array.
  */
 #define satc_point_array_alloca(name, size) \
-  double **name = NULL; \
-  name = (double **) alloca(sizeof(double *) * size);
+  SATC_REAL **name = NULL; \
+  name = (SATC_REAL **) alloca(sizeof(SATC_REAL *) * size);
 
 /**
  * Creates a pointer to an array of doubles (a point), with undefined `x` and
@@ -200,8 +974,8 @@ struct satc_response {
  * @param name the variable name for the point.
  */
 #define satc_point_alloca(name) \
-  double *name = NULL; \
-  name = (double *) alloca(sizeof(double) * 2);
+  SATC_REAL *name = NULL; \
+  name = (SATC_REAL *) alloca(sizeof(SATC_REAL) * 2);
 
 /**
  * Creates a pointer to an array of doubles (a point), with defined `x` and `y`
@@ -293,15 +1067,31 @@ struct satc_response {
 // --------------------------------------------------------------------
 
 /** Forward declaration of `satc_polygon_set_points`. */
-satc_polygon_t *satc_polygon_set_points (satc_polygon_t *polygon, size_t num_points, double **points);
-/** Forward declaration of `_satc_polygon_recalc`. */
-satc_polygon_t *_satc_polygon_recalc (satc_polygon_t *polygon);
-/** Forward declaration of `satc_box_create`. */
-satc_box_t *satc_box_create (double *pos, double w, double h);
-/** Forward declaration of `satc_box_destroy`. */
-void satc_box_destroy (satc_box_t *box);
-/** Forward declaration of `satc_box_to_polygon`. */
-satc_polygon_t *satc_box_to_polygon (satc_box_t *box);
+satc_polygon_t *satc_polygon_set_points (satc_polygon_t *polygon, size_t num_points, SATC_REAL **points);
+/** Forward declaration of `satc_box_to_small_polygon`. */
+satc_polygon_t *satc_box_to_small_polygon (satc_box_t *box, satc_small_polygon_t *small);
+/** Forward declaration of `_satc_polygon_copy_points`. */
+void _satc_polygon_copy_points (satc_polygon_t *polygon, size_t num_points, SATC_REAL **points);
+/** Forward declaration of `satc_box_to_polygon_in`. */
+satc_polygon_t *satc_box_to_polygon_in (satc_arena_t *arena, satc_box_t *box);
+/** Forward declaration of `_satc_polygon_assign_storage`. */
+void _satc_polygon_assign_storage (satc_polygon_t *polygon, SATC_REAL *storage, size_t capacity);
+/** Forward declaration of `_satc_is_separating_range`. */
+bool _satc_is_separating_range (SATC_REAL *range_a, SATC_REAL *range_b, SATC_REAL *axis, satc_response_t *response);
+/** Forward declaration of `_satc_range_overlap`. */
+SATC_REAL _satc_range_overlap (SATC_REAL *range_a, SATC_REAL *range_b, satc_response_t *response);
+/** Forward declaration of `_satc_find_normal_twins`. */
+size_t _satc_find_normal_twins (size_t num_normals, satc_points_t *normals, size_t *twins);
+/** Forward declaration of `_satc_flatten_strided_points_on`. */
+void _satc_flatten_strided_points_on (size_t len, SATC_REAL *xs, SATC_REAL *ys, size_t stride, SATC_REAL *normal, SATC_REAL *result);
+/** Forward declaration of `_satc_points_are_convex`. */
+bool _satc_points_are_convex (size_t num_points, SATC_REAL *xs, SATC_REAL *ys, size_t stride);
+/** Forward declaration of `_satc_find_normal_turn`. */
+int _satc_find_normal_turn (size_t num_normals, satc_points_t *normals, bool convex);
+/** Forward declaration of `_satc_find_normal_extents`. */
+void _satc_find_normal_extents (size_t num_points, SATC_REAL *xs, SATC_REAL *ys, size_t stride, satc_points_t *normals, size_t *twins, bool convex, satc_points_t *extents);
+/** Forward declaration of `_satc_polygon_recalc_local`. */
+satc_polygon_t *_satc_polygon_recalc_local (satc_polygon_t *polygon);
 /** Forward declaration of `satc_test_polygon_polygon`. */
 bool satc_test_polygon_polygon (satc_polygon_t *a, satc_polygon_t *b, satc_response_t *response);
 
@@ -310,37 +1100,195 @@ bool satc_test_polygon_polygon (satc_polygon_t *a, satc_polygon_t *b, satc_respo
 // ---------
 
 /**
- * Copy the values of some array of doubles (a point) `q`, onto some point `p`.
+ * Prepare an arena to hand out memory from a caller-owned block.
  *
- * `p` will be mutated.
+ * The arena never allocates or deallocates the block itself, so you are
+ * responsible for deallocating it once the arena is no longer in use.
  *
- * @param p the point to mutate.
- * @param q the point whose values to use
- * @return the mutated point.
+ * @param arena the arena to initialize.
+ * @param buffer the caller-owned block of memory.
+ * @param size the size of the block of memory, in bytes.
+ * @return the passed-in arena.
  */
-double *satc_point_copy (double *p, double *q) {
-  satc_point_set_xy(p, satc_point_get_x(q), satc_point_get_y(q));
-  return p;
+satc_arena_t *satc_arena_init (satc_arena_t *arena, void *buffer, size_t size) {
+  arena->base = (unsigned char *) buffer;
+  arena->size = size;
+  arena->used = 0;
+  return arena;
 }
 
 /**
- * Modify the values of some array of doubles (a point) `p` so they match a
- * point perpendicular to the original point.
+ * Carve some number of bytes out of an arena. The memory is aligned to
+ * `SATC_ARENA_ALIGNMENT` bytes.
  *
- * `p` will be mutated.
+ * The memory must not be deallocated, and is only released by
+ * `satc_arena_reset`.
  *
- * @param p the point to mutate.
- * @return the mutated point.
+ * @param arena the arena to allocate from.
+ * @param size the number of bytes to allocate.
+ * @return the memory, or `NULL` if the arena does not have enough room left.
  */
-double *satc_point_perp (double *p) {
-  double x = satc_point_get_y(p);
-  double y = -satc_point_get_x(p);
-  satc_point_set_xy(p, x, y);
-  return p;
+void *satc_arena_alloc (satc_arena_t *arena, size_t size) {
+  uintptr_t address = (uintptr_t) (arena->base + arena->used);
+  size_t padding = (SATC_ARENA_ALIGNMENT - address % SATC_ARENA_ALIGNMENT) % SATC_ARENA_ALIGNMENT;
+  if (padding > arena->size - arena->used || size > arena->size - arena->used - padding) return NULL;
+  void *memory = arena->base + arena->used + padding;
+  arena->used += padding + size;
+  return memory;
 }
 
 /**
- * Modify the values of some array of doubles (a point) `p` so they match an
+ * Release everything carved out of an arena at once, so the whole block can
+ * be reused.
+ *
+ * Any shapes or responses created in the arena must not be used afterward.
+ *
+ * @param arena the arena to reset.
+ * @return the passed-in arena.
+ */
+satc_arena_t *satc_arena_reset (satc_arena_t *arena) {
+  arena->used = 0;
+  return arena;
+}
+
+#ifdef SATC_ALLOC_STATS
+/**
+ * The allocation counters, kept when `SATC_ALLOC_STATS` is defined. Only heap
+ * allocations are counted, since memory carved out of an arena is owned by
+ * the caller.
+ */
+satc_alloc_stats_t satc_alloc_stats;
+
+/**
+ * Set every allocation counter back to zero.
+ *
+ * Only available when `SATC_ALLOC_STATS` is defined.
+ */
+void satc_alloc_stats_reset () {
+  size_t i = 0;
+  for (; i < SATC_ALLOC_NUM_CATEGORIES; i++) {
+    satc_alloc_stats.allocs[i] = 0;
+    satc_alloc_stats.frees[i] = 0;
+  }
+}
+
+/**
+ * Find the total number of heap allocations across every category.
+ *
+ * Only available when `SATC_ALLOC_STATS` is defined.
+ *
+ * @return the number of allocations.
+ */
+size_t satc_alloc_stats_total () {
+  size_t total = 0;
+  size_t i = 0;
+  for (; i < SATC_ALLOC_NUM_CATEGORIES; i++) total += satc_alloc_stats.allocs[i];
+  return total;
+}
+#endif
+
+/**
+ * Allocate some number of bytes, either from an arena or from the heap.
+ *
+ * Heap allocations go through `SATC_MALLOC`.
+ *
+ * For internal use.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param category the `SATC_ALLOC_*` category of the allocation.
+ * @param size the number of bytes to allocate.
+ * @return the memory, or `NULL` if it could not be allocated.
+ */
+void *_satc_alloc (satc_arena_t *arena, int category, size_t size) {
+  if (arena != NULL) return satc_arena_alloc(arena, size);
+  void *memory = SATC_MALLOC(size, category);
+#ifdef SATC_ALLOC_STATS
+  if (memory != NULL) satc_alloc_stats.allocs[category]++;
+#endif
+  return memory;
+}
+
+/**
+ * Deallocate memory returned by `_satc_alloc`. Memory carved out of an arena
+ * is left alone, since it is only released by `satc_arena_reset`.
+ *
+ * Heap deallocations go through `SATC_FREE`.
+ *
+ * For internal use.
+ *
+ * @param arena the arena the memory came from, or `NULL` for the heap.
+ * @param category the `SATC_ALLOC_*` category of the allocation.
+ * @param memory the memory to deallocate.
+ */
+void _satc_free (satc_arena_t *arena, int category, void *memory) {
+  if (arena != NULL || memory == NULL) return;
+  SATC_FREE(memory, category);
+#ifdef SATC_ALLOC_STATS
+  satc_alloc_stats.frees[category]++;
+#endif
+}
+
+/**
+ * Allocate an arena, along with a block of memory for it to hand out, on the
+ * heap. The block is counted as `SATC_ALLOC_SCRATCH`.
+ *
+ * You are responsible for deallocating the arena with `satc_arena_destroy`.
+ *
+ * @param size the size of the block of memory, in bytes.
+ * @return an arena, or `NULL` if it could not be allocated.
+ */
+satc_arena_t *satc_arena_create (size_t size) {
+  satc_arena_t *arena = NULL;
+  arena = (satc_arena_t *) _satc_alloc(NULL, SATC_ALLOC_SCRATCH, sizeof(satc_arena_t) + size);
+  if (arena == NULL) return NULL;
+  return satc_arena_init(arena, arena + 1, size);
+}
+
+/**
+ * Deallocates an arena created with `satc_arena_create`, along with
+ * everything carved out of it.
+ *
+ * @param arena the arena to deallocate.
+ */
+void satc_arena_destroy (satc_arena_t *arena) {
+  arena->base = NULL;
+  arena->size = 0;
+  arena->used = 0;
+  _satc_free(NULL, SATC_ALLOC_SCRATCH, arena);
+}
+
+/**
+ * Copy the values of some array of doubles (a point) `q`, onto some point `p`.
+ *
+ * `p` will be mutated.
+ *
+ * @param p the point to mutate.
+ * @param q the point whose values to use
+ * @return the mutated point.
+ */
+SATC_REAL *satc_point_copy (SATC_REAL *p, SATC_REAL *q) {
+  satc_point_set_xy(p, satc_point_get_x(q), satc_point_get_y(q));
+  return p;
+}
+
+/**
+ * Modify the values of some array of doubles (a point) `p` so they match a
+ * point perpendicular to the original point.
+ *
+ * `p` will be mutated.
+ *
+ * @param p the point to mutate.
+ * @return the mutated point.
+ */
+SATC_REAL *satc_point_perp (SATC_REAL *p) {
+  SATC_REAL x = satc_point_get_y(p);
+  SATC_REAL y = -satc_point_get_x(p);
+  satc_point_set_xy(p, x, y);
+  return p;
+}
+
+/**
+ * Modify the values of some array of doubles (a point) `p` so they match an
  * inverse point to the original point.
  *
  * `p` will be mutated.
@@ -348,7 +1296,7 @@ double *satc_point_perp (double *p) {
  * @param p the point to mutate.
  * @return the mutated point.
  */
-double *satc_point_reverse (double *p) {
+SATC_REAL *satc_point_reverse (SATC_REAL *p) {
   satc_point_set_xy(p, -satc_point_get_x(p), -satc_point_get_y(p));
   return p;
 }
@@ -375,7 +1323,7 @@ double *satc_point_reverse (double *p) {
  * @param p the point to query.
  * @return the length, as a double.
  */
-#define satc_point_len(p) sqrt(satc_point_len2(p))
+#define satc_point_len(p) SATC_SQRT(satc_point_len2(p))
 
 /**
  * Find the sum of two arrays of doubles (points), and replace the values of the
@@ -387,7 +1335,7 @@ double *satc_point_reverse (double *p) {
  * @param q the second point.
  * @return the mutated point.
  */
-double *satc_point_add (double *p, double *q) {
+SATC_REAL *satc_point_add (SATC_REAL *p, SATC_REAL *q) {
   satc_point_set_xy(p, satc_point_get_x(p) + satc_point_get_x(q), satc_point_get_y(p) + satc_point_get_y(q));
   return p;
 }
@@ -402,7 +1350,7 @@ double *satc_point_add (double *p, double *q) {
  * @param q the second point.
  * @return the mutated point.
  */
-double *satc_point_sub (double *p, double *q) {
+SATC_REAL *satc_point_sub (SATC_REAL *p, SATC_REAL *q) {
   satc_point_set_xy(p, satc_point_get_x(p) - satc_point_get_x(q), satc_point_get_y(p) - satc_point_get_y(q));
   return p;
 }
@@ -418,7 +1366,7 @@ double *satc_point_sub (double *p, double *q) {
  * @param y the `y` value to scale by.
  * @return the mutated point.
  */
-double *satc_point_scale_xy (double *p, double x, double y) {
+SATC_REAL *satc_point_scale_xy (SATC_REAL *p, SATC_REAL x, SATC_REAL y) {
   satc_point_set_xy(p, satc_point_get_x(p) * x, satc_point_get_y(p) * y);
   return p;
 }
@@ -432,7 +1380,7 @@ double *satc_point_scale_xy (double *p, double x, double y) {
  * @param x the `x` value to scale by, horizontally, and vertically.
  * @return the mutated point.
  */
-double *satc_point_scale_x (double *p, double x) {
+SATC_REAL *satc_point_scale_x (SATC_REAL *p, SATC_REAL x) {
   return satc_point_scale_xy(p, x, x);
 }
 
@@ -443,9 +1391,9 @@ double *satc_point_scale_x (double *p, double x) {
  *
  * @return the newly-created point.
  */
-double *satc_point_create (double x, double y) {
-  double *point = NULL;
-  point = (double *) malloc(sizeof(double) * 2);
+SATC_REAL *satc_point_create (SATC_REAL x, SATC_REAL y) {
+  SATC_REAL *point = NULL;
+  point = (SATC_REAL *) _satc_alloc(NULL, SATC_ALLOC_POINT, sizeof(SATC_REAL) * 2);
   satc_point_set_xy(point, x, y);
   return point;
 }
@@ -455,8 +1403,8 @@ double *satc_point_create (double x, double y) {
  *
  * @param point the point to deallocate.
  */
-void satc_point_destroy (double *point) {
-  free(point);
+void satc_point_destroy (SATC_REAL *point) {
+  _satc_free(NULL, SATC_ALLOC_POINT, point);
 }
 
 /**
@@ -467,10 +1415,12 @@ void satc_point_destroy (double *point) {
  * @param p the point to rotate.
  * @param angle the angle to rotate by.
  */
-double *satc_point_rotate (double *p, double angle) {
-  double x = satc_point_get_x(p);
-  double y = satc_point_get_y(p);
-  satc_point_set_xy(p, x * cos(angle) - y * sin(angle), x * sin(angle) + y * cos(angle));
+SATC_REAL *satc_point_rotate (SATC_REAL *p, SATC_REAL angle) {
+  SATC_REAL x = satc_point_get_x(p);
+  SATC_REAL y = satc_point_get_y(p);
+  SATC_REAL c = SATC_COS(angle);
+  SATC_REAL s = SATC_SIN(angle);
+  satc_point_set_xy(p, x * c - y * s, x * s + y * c);
   return p;
 }
 
@@ -482,9 +1432,11 @@ double *satc_point_rotate (double *p, double angle) {
  * @param p the point to mutate.
  * @return the normalized point.
  */
-double *satc_point_normalize (double *p) {
-  double d = satc_point_len(p);
-  if (d > 0) satc_point_set_xy(p, satc_point_get_x(p) / d, satc_point_get_y(p) / d);
+SATC_REAL *satc_point_normalize (SATC_REAL *p) {
+  SATC_REAL d = satc_point_len(p);
+  if (d > 0) {
+    satc_point_set_xy(p, satc_point_get_x(p) / d, satc_point_get_y(p) / d);
+  }
   return p;
 }
 
@@ -497,10 +1449,10 @@ double *satc_point_normalize (double *p) {
  * @param q the point used to project.
  * @return the projected point point.
  */
-double *satc_point_project (double *p, double *q) {
-  double len_2 = satc_point_len2(q);
-  if (len_2 <= DBL_EPSILON) return p;
-  double amt = satc_point_dot(p, q) / len_2;
+SATC_REAL *satc_point_project (SATC_REAL *p, SATC_REAL *q) {
+  SATC_REAL len_2 = satc_point_len2(q);
+  if (len_2 <= SATC_REAL_EPSILON) return p;
+  SATC_REAL amt = satc_point_dot(p, q) / len_2;
   satc_point_set_xy(p, amt * satc_point_get_x(q), amt * satc_point_get_y(q));
   return p;
 }
@@ -515,9 +1467,9 @@ double *satc_point_project (double *p, double *q) {
  * @param q the point used to project.
  * @return the projected point point.
  */
-double *satc_point_project_n (double *p, double *q) {
-  if (satc_point_len2(q) <= DBL_EPSILON) return p;
-  double amt = satc_point_dot(p, q);
+SATC_REAL *satc_point_project_n (SATC_REAL *p, SATC_REAL *q) {
+  if (satc_point_len2(q) <= SATC_REAL_EPSILON) return p;
+  SATC_REAL amt = satc_point_dot(p, q);
   satc_point_set_xy(p, amt * satc_point_get_x(q), amt * satc_point_get_y(q));
   return p;
 }
@@ -531,9 +1483,9 @@ double *satc_point_project_n (double *p, double *q) {
  * @param axis the angle to reflect on.
  * @return the normalized point.
  */
-double *satc_point_reflect (double *p, double *axis) {
-  double x = satc_point_get_x(p);
-  double y = satc_point_get_y(p);
+SATC_REAL *satc_point_reflect (SATC_REAL *p, SATC_REAL *axis) {
+  SATC_REAL x = satc_point_get_x(p);
+  SATC_REAL y = satc_point_get_y(p);
   satc_point_project(p, axis);
   satc_point_scale_x(p, 2.0);
   satc_point_set_xy(p, satc_point_get_x(p) - x, satc_point_get_y(p) - y);
@@ -550,9 +1502,9 @@ double *satc_point_reflect (double *p, double *axis) {
  * @param axis the angle to reflect on.
  * @return the normalized point.
  */
-double *satc_point_reflect_n (double *p, double *axis) {
-  double x = satc_point_get_x(p);
-  double y = satc_point_get_y(p);
+SATC_REAL *satc_point_reflect_n (SATC_REAL *p, SATC_REAL *axis) {
+  SATC_REAL x = satc_point_get_x(p);
+  SATC_REAL y = satc_point_get_y(p);
   satc_point_project_n(p, axis);
   satc_point_scale_x(p, 2.0);
   satc_point_set_xy(p, satc_point_get_x(p) - x, satc_point_get_y(p) - y);
@@ -560,925 +1512,3902 @@ double *satc_point_reflect_n (double *p, double *axis) {
 }
 
 /**
- * Create a struct representing a circle, with a given position and radius.
- *
- * You are responsible for deallocating the circle.
+ * Create a 2D vector from an `x` and `y` value.
  *
- * @param pos the position of the circle.
- * @param r the radius of the circle.
- * @return a circle struct.
+ * @param x the `x` value.
+ * @param y the `y` value.
+ * @return the vector.
  */
-satc_circle_t *satc_circle_create (double *pos, double r) {
-  satc_circle_t *circle = NULL;
-  circle = (satc_circle_t *) malloc(sizeof(satc_circle_t));
-  circle->type = satc_type_circle;
-  circle->pos = satc_point_clone(pos);
-  circle->r = r;
-  return circle;
+satc_vec2_t satc_vec2 (SATC_REAL x, SATC_REAL y) {
+  satc_vec2_t v;
+  v.x = x;
+  v.y = y;
+  return v;
 }
 
 /**
- * Deallocates a struct representing a circle.
+ * Read an array of doubles (a point) into a 2D vector.
  *
- * @param circle the circle to deallocate.
+ * @param p the point to read.
+ * @return the vector.
  */
-void satc_circle_destroy (satc_circle_t *circle) {
-  satc_point_destroy(circle->pos);
-  circle->type = satc_type_none;
-  circle->pos = NULL;
-  circle->r = -1.0;
-  free(circle);
+satc_vec2_t satc_vec2_load (const SATC_REAL *p) {
+  return satc_vec2(satc_point_get_x(p), satc_point_get_y(p));
 }
 
 /**
- * Returns a struct representing a rectangular polygon which is equivalent to
- * the bounding box of a circle.
+ * Write a 2D vector into an array of doubles (a point).
  *
- * You are responsible for deallocating the polygon.
+ * `p` will be mutated.
  *
- * @param circle the circle whose bounding box is of interest.
- * @return a polygon struct.
+ * @param p the point to write to.
+ * @param v the vector to write.
+ * @return the mutated point.
  */
-satc_polygon_t *satc_circle_get_aabb (satc_circle_t *circle) {
-  double r = circle->r;
-  satc_point_alloca(corner);
-  satc_point_copy(corner, circle->pos);
-  satc_point_set_xy(corner, satc_point_get_x(corner) - r, satc_point_get_y(corner) - r);
-  satc_box_t *box = satc_box_create(corner, r * 2.0, r * 2.0);
-  satc_polygon_t *polygon = satc_box_to_polygon(box);
-  satc_box_destroy(box);
-  return polygon;
+SATC_REAL *satc_vec2_store (SATC_REAL *p, satc_vec2_t v) {
+  satc_point_set_xy(p, v.x, v.y);
+  return p;
 }
 
 /**
- * Create a struct representing a polygon, with a given position and points.
- *
- * The points passed in are copied, and so you must handle the deallocation of
- * the passed-in points.
- *
- * You are responsible for deallocating the polygon.
+ * Find the sum of two 2D vectors.
  *
- * @param pos the position of the polygon.
- * @param num_points the number of points provided.
- * @param points an array of arrays of doubles (array of points).
- * @return a polygon struct.
+ * @param a the first vector.
+ * @param b the second vector.
+ * @return the sum.
  */
-satc_polygon_t *satc_polygon_create (double *pos, size_t num_points, double **points) {
-  satc_polygon_t *polygon = NULL;
-  polygon = (satc_polygon_t *) malloc(sizeof(satc_polygon_t));
-  polygon->type = satc_type_polygon;
-  polygon->pos = satc_point_clone(pos);
-  polygon->angle = 0.0;
-  polygon->offset = satc_point_create(0.0, 0.0);
-
-  polygon->num_points = 0;
-  polygon->points = NULL;
-  polygon->num_calc_points = 0;
-  polygon->calc_points = NULL;
-  polygon->num_edges = 0;
-  polygon->edges = NULL;
-  polygon->num_normals = 0;
-  polygon->normals = NULL;
-
-  satc_polygon_set_points(polygon, num_points, points);
-
-  return polygon;
+satc_vec2_t satc_vec2_add (satc_vec2_t a, satc_vec2_t b) {
+  return satc_vec2(a.x + b.x, a.y + b.y);
 }
 
 /**
- * Deallocates a struct representing a polygon.
+ * Find the difference of two 2D vectors.
  *
- * @param polygon the polygon to deallocate.
+ * @param a the first vector.
+ * @param b the second vector.
+ * @return the difference.
  */
-void satc_polygon_destroy (satc_polygon_t *polygon) {
-  satc_point_destroy(polygon->pos);
-  satc_point_destroy(polygon->offset);
-
-  size_t i = 0;
-  for (; i < polygon->num_points; i++) {
-    satc_point_destroy(polygon->points[i]);
-  }
-
-  free(polygon->points);
-
-  i = 0;
-  for (; i < polygon->num_calc_points; i++) {
-    satc_point_destroy(polygon->calc_points[i]);
-  }
-
-  free(polygon->calc_points);
-
-  i = 0;
-  for (; i < polygon->num_edges; i++) {
-    satc_point_destroy(polygon->edges[i]);
-  }
-
-  free(polygon->edges);
-
-  i = 0;
-  for (; i < polygon->num_normals; i++) {
-    satc_point_destroy(polygon->normals[i]);
-  }
-
-  free(polygon->normals);
-
-  polygon->type = satc_type_none;
-  polygon->pos = NULL;
-  polygon->num_points = 0;
-  polygon->points = NULL;
-  polygon->angle = 0.0;
-  polygon->offset = NULL;
-  polygon->num_calc_points = 0;
-  polygon->calc_points = NULL;
-  polygon->num_edges = 0;
-  polygon->edges = NULL;
-  polygon->num_normals = 0;
-  polygon->normals = NULL;
-  free(polygon);
+satc_vec2_t satc_vec2_sub (satc_vec2_t a, satc_vec2_t b) {
+  return satc_vec2(a.x - b.x, a.y - b.y);
 }
 
 /**
- * Replace a polygon struct's list of points.
- *
- * The old points will be deallocated. The new points will be deallocated when
- * the polygon is deallocated.
- *
- * The calculated values of the polygon will be recalculated.
- *
- * The points passed in are copied, and so you must handle the deallocation of
- * the passed-in points.
- *
- * For internal use.
+ * Scale a 2D vector by some value, `s`, along both axes.
  *
- * @param polygon the polygon whose points to replace.
- * @param num_points the number of new points.
- * @param points an array of arrays of doubles (array of points).
+ * @param v the vector to scale.
+ * @param s the value to scale by.
+ * @return the scaled vector.
  */
-void _satc_polygon_copy_points (satc_polygon_t *polygon, size_t num_points, double **points) {
-  if (polygon->points != NULL) {
-    size_t i = 0;
-    for (; i < polygon->num_points; i++) satc_point_destroy(polygon->points[i]);
-    free(polygon->points);
-    polygon->num_points = 0;
-    polygon->points = NULL;
-  }
-
-  double **new_points = NULL;
-  new_points = (double **) malloc(sizeof(double *) * num_points);
-  size_t i = 0;
-  for (; i < num_points; i++) new_points[i] = satc_point_clone(points[i]);
-  polygon->num_points = num_points;
-  polygon->points = new_points;
-  _satc_polygon_recalc(polygon);
+satc_vec2_t satc_vec2_scale (satc_vec2_t v, SATC_REAL s) {
+  return satc_vec2(v.x * s, v.y * s);
 }
 
 /**
- * Clear out the calculated points of a polygon and replace them with some
- * number of preallocated empty points.
- *
- * The old calculated points will be deallocated. The new points will be
- * deallocated when the polygon is deallocated.
+ * Find a 2D vector perpendicular to another.
  *
- * For internal use.
- *
- * @param polygon the polygon whose calculated points should be replaced.
- * @param num_calc_points the number of pristine points to add.
+ * @param v the vector.
+ * @return the perpendicular vector.
  */
-void _satc_polygon_reset_calc_points (satc_polygon_t *polygon, size_t num_calc_points) {
-  if (polygon->calc_points != NULL) {
-    size_t i = 0;
-    for (; i < polygon->num_calc_points; i++) satc_point_destroy(polygon->calc_points[i]);
-    free(polygon->calc_points);
-    polygon->num_calc_points = 0;
-    polygon->calc_points = NULL;
-  }
-
-  double **new_calc_points = NULL;
-  new_calc_points = (double **) malloc(sizeof(double *) * num_calc_points);
-
-  size_t i = 0;
-  for (; i < num_calc_points; i++) {
-    new_calc_points[i] = satc_point_create(0.0, 0.0);
-  }
-
-  polygon->num_calc_points = num_calc_points;
-  polygon->calc_points = new_calc_points;
+satc_vec2_t satc_vec2_perp (satc_vec2_t v) {
+  return satc_vec2(v.y, -v.x);
 }
 
 /**
- * Replace the calculated edges of a polygon with some number of pristine
- * points representing edges.
- *
- * The old calculated edges will be deallocated. The new edges will be
- * deallocated when the polygon is deallocated.
- *
- * For internal use.
+ * Find the inverse of a 2D vector.
  *
- * @param polygon the polygon whose edges should be replaced.
- * @param num_edges the number of pristine points to add.
+ * @param v the vector.
+ * @return the reversed vector.
  */
-void _satc_polygon_reset_edges (satc_polygon_t *polygon, size_t num_edges) {
-  if (polygon->edges != NULL) {
-    size_t i = 0;
-    for (; i < polygon->num_edges; i++) satc_point_destroy(polygon->edges[i]);
-    free(polygon->edges);
-    polygon->num_edges = 0;
-    polygon->edges = NULL;
-  }
-
-  double **new_edges = NULL;
-  new_edges = (double **) malloc(sizeof(double *) * num_edges);
-
-  size_t i = 0;
-  for (; i < num_edges; i++) {
-    new_edges[i] = satc_point_create(0.0, 0.0);
-  }
-
-  polygon->num_edges = num_edges;
-  polygon->edges = new_edges;
+satc_vec2_t satc_vec2_reverse (satc_vec2_t v) {
+  return satc_vec2(-v.x, -v.y);
 }
 
 /**
- * Replace the calculated normals of a polygon.
- *
- * The old calculated normals will be deallocated. The new calculated normals
- * will be deallocated when the polygon is deallocated.
+ * Find the dot product of two 2D vectors.
  *
- * For internal use.
- *
- * @param polygon the polygon whose calculated normals should be replaced.
- * @param num_normals the number of pristine normals to add.
+ * @param a the first vector.
+ * @param b the second vector.
+ * @return the dot product, as a double.
  */
-void _satc_polygon_reset_normals (satc_polygon_t *polygon, size_t num_normals) {
-  if (polygon->normals != NULL) {
-    size_t i = 0;
-    for (; i < polygon->num_normals; i++) satc_point_destroy(polygon->normals[i]);
-    free(polygon->normals);
-    polygon->num_normals = 0;
-    polygon->normals = NULL;
-  }
-
-  double **new_normals = NULL;
-  new_normals = (double **) malloc(sizeof(double *) * num_normals);
-
-  size_t i = 0;
-  for (; i < num_normals; i++) {
-    new_normals[i] = satc_point_create(0.0, 0.0);
-  }
-
-  polygon->num_normals = num_normals;
-  polygon->normals = new_normals;
+SATC_REAL satc_vec2_dot (satc_vec2_t a, satc_vec2_t b) {
+  return a.x * b.x + a.y * b.y;
 }
 
 /**
- * Given a polygon and number of points, it will clear out all of the
- * calculated values, replace the points already on the polygon, and
- * recalculate all the calculated values.
- *
- * All deallocation and allocation is handled for you.
+ * Find the length, squared, of a 2D vector.
  *
- * The points passed in are copied, and so you must handle the deallocation of
- * the passed-in points.
+ * @param v the vector.
+ * @return the length squared, as a double.
+ */
+SATC_REAL satc_vec2_len2 (satc_vec2_t v) {
+  return satc_vec2_dot(v, v);
+}
+
+/**
+ * Find the length of a 2D vector.
  *
- * @param polygon the polygon whose points should be replaced.
- * @param num_points the number of new points.
- * @param points an array of arrays of doubles (array of points).
- * @return the polygon passed in.
+ * @param v the vector.
+ * @return the length, as a double.
  */
-satc_polygon_t *satc_polygon_set_points (satc_polygon_t *polygon, size_t num_points, double **points) {
-  bool length_changed = num_points != polygon->num_points;
-  if (length_changed) {
-    _satc_polygon_reset_calc_points(polygon, num_points);
-    _satc_polygon_reset_edges(polygon, num_points);
-    _satc_polygon_reset_normals(polygon, num_points);
-  }
+SATC_REAL satc_vec2_len (satc_vec2_t v) {
+  return SATC_SQRT(satc_vec2_len2(v));
+}
 
-  _satc_polygon_copy_points(polygon, num_points, points);
-  return polygon;
+/**
+ * Rotate a 2D vector by an angle whose cosine and sine are already known.
+ *
+ * @param v the vector.
+ * @param c the cosine of the angle to rotate by.
+ * @param s the sine of the angle to rotate by.
+ * @return the rotated vector.
+ */
+satc_vec2_t satc_vec2_rotate_cs (satc_vec2_t v, SATC_REAL c, SATC_REAL s) {
+  return satc_vec2(v.x * c - v.y * s, v.x * s + v.y * c);
 }
 
 /**
- * Set the angle of rotation of the polygon. All calculated values will be
- * recalculated.
+ * Rotate a 2D vector by some angle.
  *
- * @param polygon the polygon to rotate.
+ * @param v the vector.
  * @param angle the angle to rotate by.
- * @return the passed-in polygon.
+ * @return the rotated vector.
  */
-satc_polygon_t *satc_polygon_set_angle (satc_polygon_t *polygon, double angle) {
-  polygon->angle = angle;
-  _satc_polygon_recalc(polygon);
-  return polygon;
+satc_vec2_t satc_vec2_rotate (satc_vec2_t v, SATC_REAL angle) {
+  return satc_vec2_rotate_cs(v, SATC_COS(angle), SATC_SIN(angle));
 }
 
 /**
- * Set the offset of the polygon. All calculated values will be recalculated.
+ * Normalize a 2D vector into a unit vector. A zero-length vector is returned
+ * unchanged.
  *
- * @param polygon the polygon to offset.
- * @param offset the array of doubles (a point) to offset by.
- * @return the passed-in polygon.
+ * @param v the vector.
+ * @return the normalized vector.
  */
-satc_polygon_t *satc_polygon_set_offset (satc_polygon_t *polygon, double *offset) {
-  satc_point_copy(polygon->offset, offset);
-  _satc_polygon_recalc(polygon);
-  return polygon;
+satc_vec2_t satc_vec2_normalize (satc_vec2_t v) {
+  SATC_REAL d = satc_vec2_len(v);
+  if (d > 0) return satc_vec2(v.x / d, v.y / d);
+  return v;
 }
 
 /**
- * In lieu of setting the angle of the polygon, you can actually rotate all of
- * the points. All calculated values will be recalculated.
+ * Project a 2D vector `v` onto another vector `axis`.
  *
- * @param polygon the polygon to offset.
- * @param angle the array of doubles (a point) to offset by.
- * @return the passed-in polygon.
+ * @param v the vector to project.
+ * @param axis the vector used to project.
+ * @return the projected vector.
  */
-satc_polygon_t *satc_polygon_rotate (satc_polygon_t *polygon, double angle) {
-  size_t i = 0;
-  for (; i < polygon->num_points; i++) satc_point_rotate(polygon->points[i], angle);
-  _satc_polygon_recalc(polygon);
-  return polygon;
+satc_vec2_t satc_vec2_project (satc_vec2_t v, satc_vec2_t axis) {
+  SATC_REAL len_2 = satc_vec2_len2(axis);
+  if (len_2 <= SATC_REAL_EPSILON) return v;
+  return satc_vec2_scale(axis, satc_vec2_dot(v, axis) / len_2);
 }
 
 /**
- * In lieu of setting the offset of the polygon, you can actually translate all
- * of the points by some `x` and `y`. All calculated values will be
- * recalculated.
+ * Project a 2D vector `v` onto a unit vector `axis`. The result is not divided
+ * by the length of `axis` squared.
  *
- * @param polygon the polygon to offset.
- * @param x the horizontal amount to translate by.
- * @param y the vertical amount to translate by.
- * @return the passed-in polygon.
+ * @param v the vector to project.
+ * @param axis the unit vector used to project.
+ * @return the projected vector.
  */
-satc_polygon_t *satc_polygon_translate (satc_polygon_t *polygon, double x, double y) {
-  size_t i = 0;
-  for (; i < polygon->num_points; i++) {
-    satc_point_set_xy(
-      polygon->points[i],
-      satc_point_get_x(polygon->points[i]) + x,
-      satc_point_get_y(polygon->points[i]) + y
-    );
-  }
-  _satc_polygon_recalc(polygon);
-  return polygon;
+satc_vec2_t satc_vec2_project_n (satc_vec2_t v, satc_vec2_t axis) {
+  if (satc_vec2_len2(axis) <= SATC_REAL_EPSILON) return v;
+  return satc_vec2_scale(axis, satc_vec2_dot(v, axis));
 }
 
 /**
- * Recalculates all the calculated values for a struct representing a polygon
- * shape.
+ * Reflect a 2D vector along some axis.
  *
- * For internal use.
+ * @param v the vector to reflect.
+ * @param axis the axis to reflect on.
+ * @return the reflected vector.
+ */
+satc_vec2_t satc_vec2_reflect (satc_vec2_t v, satc_vec2_t axis) {
+  return satc_vec2_sub(satc_vec2_scale(satc_vec2_project(v, axis), 2.0), v);
+}
+
+/**
+ * Reflect a 2D vector along some unit axis. When projecting, the value is not
+ * divided by the length of `axis` squared.
  *
- * @param polygon a polygon whose values should be recalculated.
- * @return the passed-in polygon.
+ * @param v the vector to reflect.
+ * @param axis the unit axis to reflect on.
+ * @return the reflected vector.
  */
-satc_polygon_t *_satc_polygon_recalc (satc_polygon_t *polygon) {
-  double **calc_points = polygon->calc_points;
-  double **edges = polygon->edges;
-  double **normals = polygon->normals;
-  double **points = polygon->points;
-  double *offset = polygon->offset;
-  double angle = polygon->angle;
-  size_t num_points = polygon->num_points;
-  size_t i = 0;
-  for (; i < num_points; i++) {
-    double *calc_point = satc_point_copy(calc_points[i], points[i]);
-    satc_point_add(calc_point, offset);
-    if (angle != 0.0) satc_point_rotate(calc_point, angle);
-  }
-
-  i = 0;
-  for (; i < num_points; i++) {
-    double *p1 = calc_points[i];
-    double *p2 = (i < num_points - 1) ? calc_points[i + 1] : calc_points[0];
-    double *edge = edges[i];
-    satc_point_copy(edge, p2);
-    satc_point_sub(edge, p1);
-    double *normal = normals[i];
-    satc_point_copy(normal, edge);
-    satc_point_perp(normal);
-    satc_point_normalize(normal);
-  }
+satc_vec2_t satc_vec2_reflect_n (satc_vec2_t v, satc_vec2_t axis) {
+  return satc_vec2_sub(satc_vec2_scale(satc_vec2_project_n(v, axis), 2.0), v);
+}
 
-  return polygon;
+/**
+ * Initialize a transform with a position and angle, calculating the cosine
+ * and sine of the angle. Nothing is allocated, so the transform can live on
+ * the stack or inside another struct.
+ *
+ * @param transform the transform to initialize.
+ * @param pos the array of doubles (a point) to use as the position.
+ * @param angle the angle of rotation.
+ * @return the passed-in transform.
+ */
+satc_transform_t *satc_transform_init (satc_transform_t *transform, SATC_REAL *pos, SATC_REAL angle) {
+  satc_point_copy(transform->pos, pos);
+  transform->angle = angle;
+  satc_point_set_xy(transform->rotation, SATC_COS(angle), SATC_SIN(angle));
+  transform->version = 0;
+  return transform;
 }
 
 /**
- * Returns a polygon struct representing the bounding box of a polygon.
+ * Set the position of a transform. Shapes referencing it pick up the change
+ * the next time they are read.
  *
- * You are responsible for deallocating the returned polygon.
+ * @param transform the transform.
+ * @param pos the array of doubles (a point) to use as the position.
+ * @return the passed-in transform.
+ */
+satc_transform_t *satc_transform_set_pos (satc_transform_t *transform, SATC_REAL *pos) {
+  satc_point_copy(transform->pos, pos);
+  transform->version++;
+  return transform;
+}
+
+/**
+ * Set the angle of a transform, calculating its cosine and sine once for all
+ * of the shapes referencing it. Setting the same angle again does nothing.
  *
- * @param polygon the polygon whose bounding box should be calculated.
- * @return a polygon representing the bounding box.
+ * @param transform the transform.
+ * @param angle the angle of rotation.
+ * @return the passed-in transform.
  */
-satc_polygon_t *satc_polygon_get_aabb (satc_polygon_t *polygon) {
-  if (polygon->num_calc_points == 0) {
-    satc_box_t *box = satc_box_create(polygon->pos, 0.0, 0.0);
-    satc_polygon_t *new_polygon = satc_box_to_polygon(box);
-    satc_box_destroy(box);
-    return new_polygon;
-  }
-
-  double x_min = satc_point_get_x(polygon->calc_points[0]) + satc_point_get_x(polygon->pos);
-  double y_min = satc_point_get_y(polygon->calc_points[0]) + satc_point_get_y(polygon->pos);
-  double x_max = x_min;
-  double y_max = y_min;
-  size_t i = 1;
-  for (; i < polygon->num_points; i++) {
-    double x = satc_point_get_x(polygon->calc_points[i]) + satc_point_get_x(polygon->pos);
-    double y = satc_point_get_y(polygon->calc_points[i]) + satc_point_get_y(polygon->pos);
-    if (x < x_min) x_min = x;
-    if (x > x_max) x_max = x;
-    if (y < y_min) y_min = y;
-    if (y > y_max) y_max = y;
-  }
+satc_transform_t *satc_transform_set_angle (satc_transform_t *transform, SATC_REAL angle) {
+  if (angle == transform->angle) return transform;
+  transform->angle = angle;
+  satc_point_set_xy(transform->rotation, SATC_COS(angle), SATC_SIN(angle));
+  transform->version++;
+  return transform;
+}
 
-  satc_point_alloca(pos);
-  satc_point_set_xy(pos, x_min, y_min);
-  satc_box_t *box = satc_box_create(pos, x_max - x_min, y_max - y_min);
-  satc_polygon_t *new_polygon = satc_box_to_polygon(box);
-  satc_box_destroy(box);
-  return new_polygon;
+/**
+ * Apply a transform to a 2D vector, rotating it and then moving it by the
+ * transform's position.
+ *
+ * @param transform the transform.
+ * @param v the vector.
+ * @return the transformed vector.
+ */
+satc_vec2_t satc_transform_apply (satc_transform_t *transform, satc_vec2_t v) {
+  satc_vec2_t rotated = satc_vec2_rotate_cs(v, satc_point_get_x(transform->rotation), satc_point_get_y(transform->rotation));
+  return satc_vec2_add(rotated, satc_vec2_load(transform->pos));
 }
 
 /**
- * Get the "centroid" (the estimated center) of a polygon as an array of
- * doubles (a point).
+ * Figure out if two axis-aligned bounding boxes overlap. Boxes which only
+ * touch count as overlapping, to match the `satc_test_*` functions.
  *
- * You are responsible for deallocating the point.
+ * @param a a bounding box.
+ * @param b another bounding box.
+ * @return true if the boxes overlap, false otherwise.
+ */
+bool satc_aabb_overlaps (satc_aabb_t *a, satc_aabb_t *b) {
+  return !(
+    satc_point_get_x(a->min) > satc_point_get_x(b->max) ||
+    satc_point_get_x(b->min) > satc_point_get_x(a->max) ||
+    satc_point_get_y(a->min) > satc_point_get_y(b->max) ||
+    satc_point_get_y(b->min) > satc_point_get_y(a->max)
+  );
+}
+
+/**
+ * Create a struct representing a circle, with a given position and radius,
+ * inside of an arena.
  *
- * @param polygon the polygon whose centroid should be calculated.
- * Degenerate polygons with zero area fall back to the arithmetic mean of
- * their calculated points.
+ * The circle is released along with the rest of the arena, and must not be
+ * passed to `satc_circle_destroy`.
  *
- * @return an array of doubles (a point) representing the centroid.
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param pos the position of the circle.
+ * @param r the radius of the circle.
+ * @return a circle struct, or `NULL` if the arena is out of room.
  */
-double *satc_polygon_get_centroid (satc_polygon_t *polygon) {
-  double **points = polygon->calc_points;
-  size_t len = polygon->num_calc_points;
-  if (len == 0) return satc_point_clone(polygon->pos);
-  double cx = 0.0;
-  double cy = 0.0;
-  double ar = 0.0;
-  size_t i = 0;
-  for (; i < len; i++) {
-    double *p1 = points[i];
-    double *p2 = (i == len - 1) ? points[0] : points[i + 1];
-    double a = satc_point_get_x(p1) * satc_point_get_y(p2) - satc_point_get_x(p2) * satc_point_get_y(p1);
-    cx += (satc_point_get_x(p1) + satc_point_get_x(p2)) * a;
-    cy += (satc_point_get_y(p1) + satc_point_get_y(p2)) * a;
-    ar += a;
-  }
-
-  if (fabs(ar) <= DBL_EPSILON) {
-    cx = 0.0;
-    cy = 0.0;
-
-    i = 0;
-    for (; i < len; i++) {
-      cx += satc_point_get_x(points[i]);
-      cy += satc_point_get_y(points[i]);
-    }
+satc_circle_t *satc_circle_create_in (satc_arena_t *arena, SATC_REAL *pos, SATC_REAL r) {
+  satc_circle_t *circle = NULL;
+  circle = (satc_circle_t *) _satc_alloc(arena, SATC_ALLOC_CIRCLE, sizeof(satc_circle_t));
+  if (circle == NULL) return NULL;
+  circle->type = satc_type_circle;
+  satc_point_copy(circle->pos, pos);
+  circle->r = r;
+  return circle;
+}
 
-    cx = cx / len;
-    cy = cy / len;
-  } else {
-    ar = ar * 3.0;
-    cx = cx / ar;
-    cy = cy / ar;
-  }
+/**
+ * Create a struct representing a circle, with a given position and radius.
+ *
+ * You are responsible for deallocating the circle.
+ *
+ * @param pos the position of the circle.
+ * @param r the radius of the circle.
+ * @return a circle struct.
+ */
+satc_circle_t *satc_circle_create (SATC_REAL *pos, SATC_REAL r) {
+  return satc_circle_create_in(NULL, pos, r);
+}
 
-  return satc_point_create(cx, cy);
+/**
+ * Deallocates a struct representing a circle.
+ *
+ * @param circle the circle to deallocate.
+ */
+void satc_circle_destroy (satc_circle_t *circle) {
+  circle->type = satc_type_none;
+  circle->r = -1.0;
+  _satc_free(NULL, SATC_ALLOC_CIRCLE, circle);
 }
 
 /**
- * Creates a struct representing a box shape.
+ * Get the bounding box of a circle, in world space. Nothing is allocated.
  *
- * @param pos the position of the box, from the top left.
- * @param w the width of the box.
- * @param h the height of the box.
- * @return a box struct.
+ * @param circle the circle whose bounding box is of interest.
+ * @param aabb the bounding box to fill in.
+ * @return the passed-in bounding box.
  */
-satc_box_t *satc_box_create (double *pos, double w, double h) {
-  satc_box_t *box = NULL;
-  box = (satc_box_t *) malloc(sizeof(satc_box_t));
-  box->type = satc_type_box;
-  box->pos = satc_point_clone(pos);
-  box->w = w;
-  box->h = h;
-  return box;
+satc_aabb_t *satc_circle_get_bounds (satc_circle_t *circle, satc_aabb_t *aabb) {
+  SATC_REAL r = circle->r;
+  satc_point_set_xy(aabb->min, satc_point_get_x(circle->pos) - r, satc_point_get_y(circle->pos) - r);
+  satc_point_set_xy(aabb->max, satc_point_get_x(circle->pos) + r, satc_point_get_y(circle->pos) + r);
+  return aabb;
 }
 
 /**
- * Deallocates a struct representing a box shape.
+ * Returns a struct representing a rectangular polygon which is equivalent to
+ * the bounding box of a circle, inside of an arena.
  *
- * @param box the box to deallocate.
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param circle the circle whose bounding box is of interest.
+ * @return a polygon struct, or `NULL` if the arena is out of room.
  */
-void satc_box_destroy (satc_box_t *box) {
-  satc_point_destroy(box->pos);
-  box->type = satc_type_none;
-  box->pos = NULL;
-  box->w = -1.0;
-  box->h = -1.0;
-  free(box);
+satc_polygon_t *satc_circle_get_aabb_in (satc_arena_t *arena, satc_circle_t *circle) {
+  satc_aabb_t aabb;
+  satc_circle_get_bounds(circle, &aabb);
+  satc_box_t box;
+  box.type = satc_type_box;
+  satc_point_copy(box.pos, aabb.min);
+  box.w = satc_point_get_x(aabb.max) - satc_point_get_x(aabb.min);
+  box.h = satc_point_get_y(aabb.max) - satc_point_get_y(aabb.min);
+  return satc_box_to_polygon_in(arena, &box);
 }
 
 /**
- * Returns a polygon representing the box.
+ * Returns a struct representing a rectangular polygon which is equivalent to
+ * the bounding box of a circle.
  *
  * You are responsible for deallocating the polygon.
  *
- * @param box the box to generate a polygon of.
- * @return a polygon representing the box.
+ * @param circle the circle whose bounding box is of interest.
+ * @return a polygon struct.
  */
-satc_polygon_t *satc_box_to_polygon (satc_box_t *box) {
-  double *pos = box->pos;
-  double w = box->w;
-  double h = box->h;
-  double **points = NULL;
-  points = (double **) alloca(sizeof(double *) * 4);
-  satc_point_alloca(nw);
-  satc_point_alloca(ne);
-  satc_point_alloca(se);
-  satc_point_alloca(sw);
-  satc_point_set_xy(nw, 0.0, 0.0);
-  satc_point_set_xy(ne, w, 0.0);
-  satc_point_set_xy(se, w, h);
-  satc_point_set_xy(sw, 0.0, h);
-  points[0] = nw;
-  points[1] = ne;
-  points[2] = se;
-  points[3] = sw;
-  return satc_polygon_create(pos, 4, points);
+satc_polygon_t *satc_circle_get_aabb (satc_circle_t *circle) {
+  return satc_circle_get_aabb_in(NULL, circle);
 }
 
 /**
- * Creates a struct representing a collision response.
+ * Create an empty set of circles with room for a given number of circles,
+ * inside of an arena.
  *
- * Instead of setting the values manually, you should use a `satc_test_*`
- * function, which will set the values for you.
+ * The set is released along with the rest of the arena, and must not be
+ * passed to `satc_circle_set_destroy`.
  *
- * @return a struct representing a collision response.
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param capacity the number of circles the set has room for.
+ * @return a circle set struct, or `NULL` if the arena is out of room.
  */
-satc_response_t *satc_response_create () {
-  satc_response_t *response = NULL;
-  response = (satc_response_t *) malloc(sizeof(satc_response_t));
-  response->a = NULL;
-  response->b = NULL;
-  response->overlap_n = satc_point_create(0.0, 0.0);
-  response->overlap_v = satc_point_create(0.0, 0.0);
-  response->overlap = DBL_MAX;
-  response->a_in_b = true;
-  response->b_in_a = true;
-  return response;
+satc_circle_set_t *satc_circle_set_create_in (satc_arena_t *arena, size_t capacity) {
+  satc_circle_set_t *set = NULL;
+  set = (satc_circle_set_t *) _satc_alloc(arena, SATC_ALLOC_CIRCLE, sizeof(satc_circle_set_t) + sizeof(SATC_REAL) * 3 * capacity);
+  if (set == NULL) return NULL;
+  set->count = 0;
+  set->capacity = capacity;
+  set->x = (SATC_REAL *) (set + 1);
+  set->y = set->x + capacity;
+  set->r = set->y + capacity;
+  return set;
 }
 
 /**
- * Resets a collision response so it can be reused safely.
+ * Create an empty set of circles with room for a given number of circles.
  *
- * @param response the response to reset.
- * @return the reset response.
+ * The set must be deallocated with `satc_circle_set_destroy`.
+ *
+ * @param capacity the number of circles the set has room for.
+ * @return a circle set struct.
  */
-satc_response_t *satc_response_clear (satc_response_t *response) {
-  response->a = NULL;
-  response->b = NULL;
-  satc_point_set_xy(response->overlap_n, 0.0, 0.0);
-  satc_point_set_xy(response->overlap_v, 0.0, 0.0);
-  response->overlap = DBL_MAX;
-  response->a_in_b = true;
-  response->b_in_a = true;
-  return response;
+satc_circle_set_t *satc_circle_set_create (size_t capacity) {
+  return satc_circle_set_create_in(NULL, capacity);
 }
 
 /**
- * Deallocates a struct representing a collision response.
- *
- * `response->a` and `response->b` are not deallocated for you!
+ * Deallocates a set of circles.
  *
- * @param response the response to deallocate.
+ * @param set the set to deallocate.
  */
-void satc_response_destroy (satc_response_t *response) {
-  satc_point_destroy(response->overlap_n);
-  satc_point_destroy(response->overlap_v);
-
-  response->a = NULL;
-  response->b = NULL;
-  response->overlap_n = NULL;
-  response->overlap_v = NULL;
-  response->overlap = DBL_MAX;
-  response->a_in_b = true;
-  response->b_in_a = true;
-  free(response);
+void satc_circle_set_destroy (satc_circle_set_t *set) {
+  set->count = 0;
+  set->capacity = 0;
+  _satc_free(NULL, SATC_ALLOC_CIRCLE, set);
 }
 
 /**
- * Project the array of arrays of doubles (array of points) onto an axis.
+ * Adds a circle to a set of circles.
  *
- * @param len the number of points.
- * @param points the array of arrays of doubles (points) to project.
- * @param normal the array of doubles (a point) of the normal.
- * @param result the arary of doubles (a point) representing the result.
+ * @param set the set to add to.
+ * @param pos the position of the circle.
+ * @param r the radius of the circle.
+ * @return the index of the circle in the set, or `SIZE_MAX` if the set is
+ * full.
  */
-void satc_flatten_points_on (size_t len, double **points, double *normal, double *result) {
-  double min = DBL_MAX;
-  double max = -DBL_MAX;
-
-  size_t i = 0;
-  for (; i < len; i++) {
-    double dot = satc_point_dot(points[i], normal);
-    if (dot < min) min = dot;
-    if (dot > max) max = dot;
-  }
-
-  result[0] = min;
-  result[1] = max;
+size_t satc_circle_set_add (satc_circle_set_t *set, SATC_REAL *pos, SATC_REAL r) {
+  if (set->count == set->capacity) return SIZE_MAX;
+  size_t i = set->count++;
+  set->x[i] = satc_point_get_x(pos);
+  set->y[i] = satc_point_get_y(pos);
+  set->r[i] = r;
+  return i;
 }
 
 /**
- * Figure out if two arrays of arrays of doubles (two arrays of points)
- * represent a separating axis.
+ * Create a struct representing shared polygon geometry, with the given
+ * points, inside of an arena. Its edges and normals are calculated once, up
+ * front. The geometry starts out with a single reference.
  *
- * Primarily meant for internal use.
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
  *
- * @param a_pos an array of doubles (a point).
- * @param b_pos an array of doubles (a point).
- * @param a_len the number of points in `a_points`.
- * @param a_points an array of arrays of doubles (an array of points).
- * @param b_len the number of points in `b_points`.
- * @param b_points an array of arrays of doubles (an array of points).
- * @param axis the axis as an array of doubles (a point).
- * @param response the collision response to mutate.
- * @return whether this represents a separating axis, as a boolean.
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param num_points the number of points provided.
+ * @param points an array of arrays of doubles (array of points).
+ * @return a geometry struct, or `NULL` if the arena is out of room.
  */
-bool satc_is_separating_axis (double *a_pos, double *b_pos, size_t a_len, double **a_points, size_t b_len, double **b_points, double *axis, satc_response_t *response) {
-  // Allocate temporary variables.
-  satc_double_array_alloca(range_a, 2);
-  satc_double_array_alloca(range_b, 2);
-  satc_point_alloca(offset_v);
-
-  // The magnitude of the offset between the two polygons.
-  satc_point_copy(offset_v, b_pos);
-  satc_point_sub(offset_v, a_pos);
-  double projected_offset = satc_point_dot(offset_v, axis);
-  // Project the polygons onto the axis.
-  satc_flatten_points_on(a_len, a_points, axis, range_a);
-  satc_flatten_points_on(b_len, b_points, axis, range_b);
-  // Move B's range to its position relative to A.
-  range_b[0] += projected_offset;
-  range_b[1] += projected_offset;
-  // Check if there is a gap. If there is, this is a separating axis and we can stop.
-  if (range_a[0] > range_b[1] || range_b[0] > range_a[1]) {
-    return true;
+satc_geometry_t *satc_geometry_create_in (satc_arena_t *arena, size_t num_points, SATC_REAL **points) {
+  size_t used = arena != NULL ? arena->used : 0;
+  satc_geometry_t *geometry = NULL;
+  geometry = (satc_geometry_t *) _satc_alloc(arena, SATC_ALLOC_GEOMETRY, sizeof(satc_geometry_t));
+  if (geometry == NULL) return NULL;
+  SATC_REAL *storage = NULL;
+  storage = (SATC_REAL *) _satc_alloc(arena, SATC_ALLOC_GEOMETRY, sizeof(SATC_REAL) * (num_points * 8 + _satc_index_reals(num_points)));
+  if (storage == NULL && num_points > 0) {
+    // Hand the geometry struct back, so a failed create does not use up room.
+    if (arena != NULL) arena->used = used;
+    _satc_free(arena, SATC_ALLOC_GEOMETRY, geometry);
+    return NULL;
   }
 
-  // This is not a separating axis. If we're calculating a response, calculate the overlap.
-  if (response != NULL) {
-    double overlap = 0;
-    // A starts further left than B.
-    if (range_a[0] < range_b[0]) {
-      response->a_in_b = false;
-      // A ends before B does. We have to pull A out of B.
-      if (range_a[1] < range_b[1]) {
-        overlap = range_a[1] - range_b[1];
-        response->b_in_a = false;
-      // B is fully inside A. Pick the shortest way out.
-      } else {
-        double option_1 = range_a[1] - range_b[0];
-        double option_2 = range_b[1] - range_a[0];
-        overlap = option_1 < option_2 ? option_1 : -option_2;
-      }
-    // B starts further left than A.
-    } else {
-      response->b_in_a = false;
-      // B ends before A ends. We have to push A out of B.
-      if (range_a[1] > range_b[1]) {
-        overlap = range_a[0] - range_b[1];
-        response->a_in_b = false;
-      // A is fully inside B.  Pick the shortest way out.
-      } else {
-        double option_1 = range_a[1] - range_b[0];
-        double option_2 = range_b[1] - range_a[0];
-        overlap = option_1 < option_2 ? option_1 : -option_2;
-      }
-    }
+  geometry->num_points = num_points;
+  geometry->points.x = storage;
+  geometry->points.y = storage + num_points;
+  geometry->edges.x = storage + num_points * 2;
+  geometry->edges.y = storage + num_points * 3;
+  geometry->normals.x = storage + num_points * 4;
+  geometry->normals.y = storage + num_points * 5;
+  geometry->normal_extents.x = storage + num_points * 6;
+  geometry->normal_extents.y = storage + num_points * 7;
+  geometry->normal_twins = (size_t *) (storage + num_points * 8);
+  geometry->refs = 1;
+  geometry->storage = storage;
+  geometry->arena = arena;
 
-    // If this is the smallest amount of overlap we've seen so far, set it as the minimum overlap.
-    double abs_overlap = fabs(overlap);
-    if (abs_overlap < response->overlap) {
-      response->overlap = abs_overlap;
-      satc_point_copy(response->overlap_n, axis);
-      if (overlap < 0) {
-        satc_point_reverse(response->overlap_n);
-      }
-    }
+  size_t i = 0;
+  for (; i < num_points; i++) {
+    geometry->points.x[i] = satc_point_get_x(points[i]);
+    geometry->points.y[i] = satc_point_get_y(points[i]);
   }
+  for (i = 0; i < num_points; i++) {
+    size_t next = (i < num_points - 1) ? i + 1 : 0;
+    satc_vec2_t edge = satc_vec2(geometry->points.x[next] - geometry->points.x[i], geometry->points.y[next] - geometry->points.y[i]);
+    satc_vec2_t normal = satc_vec2_normalize(satc_vec2_perp(edge));
+    geometry->edges.x[i] = edge.x;
+    geometry->edges.y[i] = edge.y;
+    geometry->normals.x[i] = normal.x;
+    geometry->normals.y[i] = normal.y;
+  }
+  geometry->num_axes = _satc_find_normal_twins(num_points, &geometry->normals, geometry->normal_twins);
+  geometry->convex = _satc_points_are_convex(num_points, geometry->points.x, geometry->points.y, 1);
+  geometry->normal_turn = _satc_find_normal_turn(num_points, &geometry->normals, geometry->convex);
+  _satc_find_normal_extents(num_points, geometry->points.x, geometry->points.y, 1, &geometry->normals, geometry->normal_twins, geometry->convex, &geometry->normal_extents);
 
-  return false;
+  return geometry;
 }
 
 /**
- * Figure out if an array of doubles (a point) representing a line, and another
- * point represent either a left, middle, or right voronoi region.
+ * Create a struct representing shared polygon geometry, with the given
+ * points. The geometry starts out with a single reference.
  *
- * @param line an array of doubles (a point) representing a line.
- * @param point an array of doubles (a point).
- * @return an integer (-1, 0, or 1) representing which voronoi region was found.
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * You are responsible for releasing the geometry with
+ * `satc_geometry_release`.
+ *
+ * @param num_points the number of points provided.
+ * @param points an array of arrays of doubles (array of points).
+ * @return a geometry struct.
  */
-int satc_voronoi_region (double *line, double *point) {
-  double len_2 = satc_point_len2(line);
-  double dp = satc_point_dot(point, line);
-  // If the point is beyond the start of the line, it is in the left voronoi region.
-  if (dp < 0) return SATC_LEFT_VORONOI_REGION;
-  // If the point is beyond the end of the line, it is in the right voronoi region.
-  if (dp > len_2) return SATC_RIGHT_VORONOI_REGION;
-  return SATC_MIDDLE_VORONOI_REGION;
+satc_geometry_t *satc_geometry_create (size_t num_points, SATC_REAL **points) {
+  return satc_geometry_create_in(NULL, num_points, points);
 }
 
 /**
- * Returns true if an array of doubles (a point) is inside of a circle.
+ * Add a reference to shared polygon geometry.
  *
- * @param p an array of doubles (a point).
- * @param c a circle.
- * @return true if point is inside of circle, false otherwise.
+ * @param geometry the geometry.
+ * @return the passed-in geometry.
  */
-bool satc_point_in_circle (double *point, satc_circle_t *circle) {
-  satc_point_alloca(difference_v);
-  satc_point_copy(difference_v, point);
-  satc_point_sub(difference_v, circle->pos);
-  double radius_sq = circle->r * circle->r;
-  double distance_sq = satc_point_len2(difference_v);
-  return distance_sq <= radius_sq;
+satc_geometry_t *satc_geometry_retain (satc_geometry_t *geometry) {
+  geometry->refs++;
+  return geometry;
 }
 
 /**
- * Creates a very small polygon representing a point, for collision purposes.
- *
- * For internal use.
- *
- * You are responsible for deallocating the polygon.
+ * Remove a reference to shared polygon geometry, deallocating it once the
+ * last reference is gone. Geometry created in an arena is only released
+ * along with the rest of the arena.
  *
- * @return a polygon.
+ * @param geometry the geometry.
  */
-satc_polygon_t *_satc_test_point_create () {
-  satc_point_alloca(zero);
-  satc_point_set_xy(zero, 0.0, 0.0);
-  satc_box_t *box = satc_box_create(zero, 0.000001, 0.000001);
-  satc_polygon_t *polygon = satc_box_to_polygon(box);
-  satc_box_destroy(box);
-  return polygon;
+void satc_geometry_release (satc_geometry_t *geometry) {
+  if (--geometry->refs > 0) return;
+  satc_arena_t *arena = geometry->arena;
+  _satc_free(arena, SATC_ALLOC_GEOMETRY, geometry->storage);
+  geometry->num_points = 0;
+  geometry->normal_twins = NULL;
+  geometry->normal_extents.x = NULL;
+  geometry->normal_extents.y = NULL;
+  geometry->storage = NULL;
+  geometry->arena = NULL;
+  _satc_free(arena, SATC_ALLOC_GEOMETRY, geometry);
 }
 
 /**
- * Returns true if an array of doubles (a point) is inside of a polygon.
+ * Create a struct representing a polygon, with a given position and points,
+ * inside of an arena. The polygon's storage is carved out of the same arena.
  *
- * @param p an array of doubles (a point).
- * @param polygon a polygon.
- * @return true if point is inside of polygon, false otherwise.
- */
-bool satc_point_in_polygon (double *point, satc_polygon_t *polygon) {
-  if (polygon->num_calc_points == 0) return false;
-
-  satc_polygon_t *test_point = _satc_test_point_create();
-  satc_point_copy(test_point->pos, point);
-  satc_response_t *response = satc_response_create();
-
-  bool result = satc_test_polygon_polygon(test_point, polygon, response);
-  if (result) result = response->a_in_b;
-
-  satc_response_destroy(response);
-  satc_polygon_destroy(test_point);
-
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * The polygon is released along with the rest of the arena. Passing it to
+ * `satc_polygon_destroy` is allowed, but does not give any memory back.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param pos the position of the polygon.
+ * @param num_points the number of points provided.
+ * @param points an array of arrays of doubles (array of points).
+ * @return a polygon struct, or `NULL` if the arena is out of room.
+ */
+satc_polygon_t *satc_polygon_create_in (satc_arena_t *arena, SATC_REAL *pos, size_t num_points, SATC_REAL **points) {
+  size_t used = arena != NULL ? arena->used : 0;
+  satc_polygon_t *polygon = NULL;
+  polygon = (satc_polygon_t *) _satc_alloc(arena, SATC_ALLOC_POLYGON, sizeof(satc_polygon_t));
+  if (polygon == NULL) return NULL;
+  polygon->type = satc_type_polygon;
+  satc_point_copy(polygon->pos, pos);
+  polygon->angle = 0.0;
+  satc_point_set_xy(polygon->rotation, 1.0, 0.0);
+  satc_point_set_xy(polygon->offset, 0.0, 0.0);
+
+  polygon->num_points = 0;
+  polygon->capacity = 0;
+  polygon->points.x = NULL;
+  polygon->points.y = NULL;
+  polygon->points_stride = 1;
+  polygon->points_borrowed = false;
+  polygon->num_calc_points = 0;
+  polygon->calc_points.x = NULL;
+  polygon->calc_points.y = NULL;
+  polygon->num_edges = 0;
+  polygon->edges.x = NULL;
+  polygon->edges.y = NULL;
+  polygon->num_normals = 0;
+  polygon->normals.x = NULL;
+  polygon->normals.y = NULL;
+  polygon->local_normals.x = NULL;
+  polygon->local_normals.y = NULL;
+  polygon->normal_twins = NULL;
+  polygon->num_axes = 0;
+  polygon->normal_extents.x = NULL;
+  polygon->normal_extents.y = NULL;
+  polygon->convex = true;
+  polygon->normal_turn = 0;
+  polygon->storage = NULL;
+  polygon->arena = arena;
+  polygon->dirty = 0;
+  polygon->transform = NULL;
+  polygon->transform_version = 0;
+  polygon->geometry = NULL;
+  polygon->storage_inline = false;
+  polygon->embedded = false;
+
+  if (satc_polygon_set_points(polygon, num_points, points) == NULL) {
+    // Hand the polygon struct back, so a failed create does not use up room.
+    if (arena != NULL) arena->used = used;
+    _satc_free(arena, SATC_ALLOC_POLYGON, polygon);
+    return NULL;
+  }
+
+  return polygon;
+}
+
+/**
+ * Create a struct representing a polygon, with a given position and points.
+ *
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * You are responsible for deallocating the polygon.
+ *
+ * @param pos the position of the polygon.
+ * @param num_points the number of points provided.
+ * @param points an array of arrays of doubles (array of points).
+ * @return a polygon struct.
+ */
+satc_polygon_t *satc_polygon_create (SATC_REAL *pos, size_t num_points, SATC_REAL **points) {
+  return satc_polygon_create_in(NULL, pos, num_points, points);
+}
+
+/**
+ * Create a struct representing a polygon which is an instance of some shared
+ * geometry, with a given position, inside of an arena.
+ *
+ * Nothing is copied, so this takes constant time no matter how many points
+ * the geometry has. The instance adds a reference to the geometry, which is
+ * removed when the instance is destroyed. The instance's calculated values
+ * are only allocated the first time they are needed, and never if it is only
+ * tested with `satc_test_polygon_polygon_local`.
+ *
+ * Replacing, rotating, or translating the points of an instance gives it its
+ * own copy of them first, so the geometry is never modified.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param pos the position of the polygon.
+ * @param geometry the geometry to share.
+ * @return a polygon struct, or `NULL` if the arena is out of room.
+ */
+satc_polygon_t *satc_polygon_create_instance_in (satc_arena_t *arena, SATC_REAL *pos, satc_geometry_t *geometry) {
+  satc_polygon_t *polygon = NULL;
+  polygon = (satc_polygon_t *) _satc_alloc(arena, SATC_ALLOC_POLYGON, sizeof(satc_polygon_t));
+  if (polygon == NULL) return NULL;
+  polygon->type = satc_type_polygon;
+  satc_point_copy(polygon->pos, pos);
+  polygon->angle = 0.0;
+  satc_point_set_xy(polygon->rotation, 1.0, 0.0);
+  satc_point_set_xy(polygon->offset, 0.0, 0.0);
+
+  polygon->num_points = geometry->num_points;
+  polygon->capacity = 0;
+  polygon->points = geometry->points;
+  polygon->points_stride = 1;
+  polygon->points_borrowed = true;
+  polygon->num_calc_points = 0;
+  polygon->calc_points.x = NULL;
+  polygon->calc_points.y = NULL;
+  polygon->num_edges = 0;
+  polygon->edges.x = NULL;
+  polygon->edges.y = NULL;
+  polygon->num_normals = 0;
+  polygon->normals.x = NULL;
+  polygon->normals.y = NULL;
+  polygon->local_normals = geometry->normals;
+  polygon->normal_twins = geometry->normal_twins;
+  polygon->num_axes = geometry->num_axes;
+  polygon->normal_extents = geometry->normal_extents;
+  polygon->convex = geometry->convex;
+  polygon->normal_turn = geometry->normal_turn;
+  polygon->storage = NULL;
+  polygon->arena = arena;
+  polygon->dirty = SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES;
+  polygon->transform = NULL;
+  polygon->transform_version = 0;
+  polygon->geometry = satc_geometry_retain(geometry);
+  polygon->storage_inline = false;
+  polygon->embedded = false;
+  return polygon;
+}
+
+/**
+ * Create a struct representing a polygon which is an instance of some shared
+ * geometry, with a given position. See `satc_polygon_create_instance_in`.
+ *
+ * You are responsible for deallocating the polygon.
+ *
+ * @param pos the position of the polygon.
+ * @param geometry the geometry to share.
+ * @return a polygon struct.
+ */
+satc_polygon_t *satc_polygon_create_instance (SATC_REAL *pos, satc_geometry_t *geometry) {
+  return satc_polygon_create_instance_in(NULL, pos, geometry);
+}
+
+/**
+ * Create a struct representing a polygon which is a view over a caller-owned
+ * buffer of points, with a given position, inside of an arena.
+ *
+ * The points are read straight from the buffer, which is never copied,
+ * modified, or deallocated by the polygon, so it must outlive the polygon.
+ * The `x` and `y` values can be interleaved, as in a vertex buffer, or kept
+ * in separate arrays. For example, a buffer of `x, y, u, v` vertices is
+ * viewed with `xs` at the first value, `ys` at the second, and a stride of 4.
+ *
+ * After changing the values in the buffer, call `satc_polygon_invalidate`.
+ * Replacing, rotating, or translating the points of a view gives it its own
+ * copy of them first.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param pos the position of the polygon.
+ * @param num_points the number of points in the buffer.
+ * @param xs the `x` value of the first point.
+ * @param ys the `y` value of the first point.
+ * @param stride the distance from one point's values to the next, counted in
+ * `SATC_REAL` values.
+ * @return a polygon struct, or `NULL` if the arena is out of room.
+ */
+satc_polygon_t *satc_polygon_create_view_in (satc_arena_t *arena, SATC_REAL *pos, size_t num_points, SATC_REAL *xs, SATC_REAL *ys, size_t stride) {
+  size_t used = arena != NULL ? arena->used : 0;
+  satc_polygon_t *polygon = NULL;
+  polygon = (satc_polygon_t *) _satc_alloc(arena, SATC_ALLOC_POLYGON, sizeof(satc_polygon_t));
+  if (polygon == NULL) return NULL;
+  SATC_REAL *storage = NULL;
+  storage = (SATC_REAL *) _satc_alloc(arena, SATC_ALLOC_POLYGON, sizeof(SATC_REAL) * (num_points * 10 + _satc_index_reals(num_points)));
+  if (storage == NULL && num_points > 0) {
+    // Hand the polygon struct back, so a failed create does not use up room.
+    if (arena != NULL) arena->used = used;
+    _satc_free(arena, SATC_ALLOC_POLYGON, polygon);
+    return NULL;
+  }
+
+  polygon->type = satc_type_polygon;
+  satc_point_copy(polygon->pos, pos);
+  polygon->angle = 0.0;
+  satc_point_set_xy(polygon->rotation, 1.0, 0.0);
+  satc_point_set_xy(polygon->offset, 0.0, 0.0);
+
+  polygon->num_points = num_points;
+  polygon->capacity = 0;
+  polygon->points.x = xs;
+  polygon->points.y = ys;
+  polygon->points_stride = stride;
+  polygon->points_borrowed = true;
+  polygon->num_calc_points = num_points;
+  polygon->calc_points.x = storage;
+  polygon->calc_points.y = storage + num_points;
+  polygon->num_edges = num_points;
+  polygon->edges.x = storage + num_points * 2;
+  polygon->edges.y = storage + num_points * 3;
+  polygon->num_normals = num_points;
+  polygon->normals.x = storage + num_points * 4;
+  polygon->normals.y = storage + num_points * 5;
+  polygon->local_normals.x = storage + num_points * 6;
+  polygon->local_normals.y = storage + num_points * 7;
+  polygon->normal_extents.x = storage + num_points * 8;
+  polygon->normal_extents.y = storage + num_points * 9;
+  polygon->normal_twins = (size_t *) (storage + num_points * 10);
+  polygon->num_axes = num_points;
+  polygon->convex = true;
+  polygon->normal_turn = 0;
+  polygon->storage = storage;
+  polygon->arena = arena;
+  polygon->dirty = SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES | SATC_POLYGON_DIRTY_LOCAL_NORMALS;
+  polygon->transform = NULL;
+  polygon->transform_version = 0;
+  polygon->geometry = NULL;
+  polygon->storage_inline = false;
+  polygon->embedded = false;
+  return polygon;
+}
+
+/**
+ * Create a struct representing a polygon which is a view over a caller-owned
+ * buffer of points, with a given position. See `satc_polygon_create_view_in`.
+ *
+ * You are responsible for deallocating the polygon, but not the buffer.
+ *
+ * @param pos the position of the polygon.
+ * @param num_points the number of points in the buffer.
+ * @param xs the `x` value of the first point.
+ * @param ys the `y` value of the first point.
+ * @param stride the distance from one point's values to the next, counted in
+ * `SATC_REAL` values.
+ * @return a polygon struct.
+ */
+satc_polygon_t *satc_polygon_create_view (SATC_REAL *pos, size_t num_points, SATC_REAL *xs, SATC_REAL *ys, size_t stride) {
+  return satc_polygon_create_view_in(NULL, pos, num_points, xs, ys, stride);
+}
+
+/**
+ * Set up a small polygon, with a given position and points, in its own inline
+ * storage. Nothing is allocated, so the small polygon can live on the stack
+ * or inside of another struct.
+ *
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * A small polygon which later grows past its capacity moves into allocated
+ * storage, so pass it to `satc_polygon_destroy` if that might have happened.
+ *
+ * @param small the small polygon to set up.
+ * @param pos the position of the polygon.
+ * @param num_points the number of points provided.
+ * @param points an array of arrays of doubles (array of points).
+ * @return the polygon inside of `small`, or `NULL` if there are more than
+ * `SATC_SMALL_POLYGON_CAPACITY` points.
+ */
+satc_polygon_t *satc_small_polygon_init (satc_small_polygon_t *small, SATC_REAL *pos, size_t num_points, SATC_REAL **points) {
+  if (num_points > SATC_SMALL_POLYGON_CAPACITY) return NULL;
+  satc_polygon_t *polygon = &small->polygon;
+  polygon->type = satc_type_polygon;
+  satc_point_copy(polygon->pos, pos);
+  polygon->angle = 0.0;
+  satc_point_set_xy(polygon->rotation, 1.0, 0.0);
+  satc_point_set_xy(polygon->offset, 0.0, 0.0);
+
+  _satc_polygon_assign_storage(polygon, small->storage, SATC_SMALL_POLYGON_CAPACITY);
+  polygon->points_stride = 1;
+  polygon->points_borrowed = false;
+  polygon->arena = NULL;
+  polygon->dirty = 0;
+  polygon->transform = NULL;
+  polygon->transform_version = 0;
+  polygon->geometry = NULL;
+  polygon->storage_inline = true;
+  polygon->embedded = true;
+  _satc_polygon_copy_points(polygon, num_points, points);
+  return polygon;
+}
+
+/**
+ * Create a small polygon, with a given position and points, as a single
+ * block of memory inside of an arena. See `satc_small_polygon_init`.
+ *
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param pos the position of the polygon.
+ * @param num_points the number of points provided.
+ * @param points an array of arrays of doubles (array of points).
+ * @return a polygon struct, or `NULL` if the arena is out of room or there
+ * are more than `SATC_SMALL_POLYGON_CAPACITY` points.
+ */
+satc_polygon_t *satc_small_polygon_create_in (satc_arena_t *arena, SATC_REAL *pos, size_t num_points, SATC_REAL **points) {
+  if (num_points > SATC_SMALL_POLYGON_CAPACITY) return NULL;
+  satc_small_polygon_t *small = NULL;
+  small = (satc_small_polygon_t *) _satc_alloc(arena, SATC_ALLOC_POLYGON, sizeof(satc_small_polygon_t));
+  if (small == NULL) return NULL;
+  satc_polygon_t *polygon = satc_small_polygon_init(small, pos, num_points, points);
+  polygon->arena = arena;
+  polygon->embedded = false;
+  return polygon;
+}
+
+/**
+ * Create a small polygon, with a given position and points, as a single
+ * block of memory. See `satc_small_polygon_init`.
+ *
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * You are responsible for deallocating the polygon.
+ *
+ * @param pos the position of the polygon.
+ * @param num_points the number of points provided.
+ * @param points an array of arrays of doubles (array of points).
+ * @return a polygon struct, or `NULL` if there are more than
+ * `SATC_SMALL_POLYGON_CAPACITY` points.
+ */
+satc_polygon_t *satc_small_polygon_create (SATC_REAL *pos, size_t num_points, SATC_REAL **points) {
+  return satc_small_polygon_create_in(NULL, pos, num_points, points);
+}
+
+/**
+ * Deallocates a struct representing a polygon.
+ *
+ * Small polygons set up on the stack with `satc_small_polygon_init` can be
+ * passed here too, which only deallocates storage they grew into.
+ *
+ * @param polygon the polygon to deallocate.
+ */
+void satc_polygon_destroy (satc_polygon_t *polygon) {
+  satc_arena_t *arena = polygon->arena;
+  if (!polygon->storage_inline) _satc_free(arena, SATC_ALLOC_POLYGON, polygon->storage);
+
+  polygon->type = satc_type_none;
+  polygon->num_points = 0;
+  polygon->capacity = 0;
+  polygon->points.x = NULL;
+  polygon->points.y = NULL;
+  polygon->points_borrowed = false;
+  polygon->angle = 0.0;
+  polygon->num_calc_points = 0;
+  polygon->calc_points.x = NULL;
+  polygon->calc_points.y = NULL;
+  polygon->num_edges = 0;
+  polygon->edges.x = NULL;
+  polygon->edges.y = NULL;
+  polygon->num_normals = 0;
+  polygon->normals.x = NULL;
+  polygon->normals.y = NULL;
+  polygon->local_normals.x = NULL;
+  polygon->local_normals.y = NULL;
+  polygon->normal_twins = NULL;
+  polygon->num_axes = 0;
+  polygon->normal_extents.x = NULL;
+  polygon->normal_extents.y = NULL;
+  polygon->storage = NULL;
+  polygon->arena = NULL;
+  polygon->transform = NULL;
+  if (polygon->geometry != NULL) satc_geometry_release(polygon->geometry);
+  polygon->geometry = NULL;
+  polygon->storage_inline = false;
+  if (!polygon->embedded) _satc_free(arena, SATC_ALLOC_POLYGON, polygon);
+}
+
+/**
+ * Make sure a polygon's storage can hold at least some number of points.
+ *
+ * If the storage is already large enough, nothing happens. Otherwise, the old
+ * storage is replaced by a single new block, split into the `x` and `y`
+ * arrays of `points`, `calc_points`, `edges`, `normals`, `local_normals`,
+ * and `normal_extents`, along with `normal_twins`. The contents of the old
+ * storage are not preserved. Polygons created in an arena grow into that
+ * same arena, where the old storage stays used until the arena is reset, and
+ * small polygons move out of their inline storage.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon whose storage should be grown.
+ * @param capacity the number of points the storage must hold.
+ * @return true if the storage can hold `capacity` points, false if it could
+ * not be allocated, in which case the polygon is left unchanged.
+ */
+bool _satc_polygon_reserve (satc_polygon_t *polygon, size_t capacity) {
+  if (capacity <= polygon->capacity) return true;
+
+  // Everything in the storage is written again afterwards, so there is
+  // nothing to copy over. The new block is allocated before the old one is
+  // freed, so the polygon is left alone if it can not be.
+  SATC_REAL *storage = NULL;
+  storage = (SATC_REAL *) _satc_alloc(polygon->arena, SATC_ALLOC_POLYGON, sizeof(SATC_REAL) * _satc_polygon_storage_reals(capacity));
+  if (storage == NULL) return false;
+  // Inline storage is part of the polygon, so it is not freed.
+  if (!polygon->storage_inline) _satc_free(polygon->arena, SATC_ALLOC_POLYGON, polygon->storage);
+
+  _satc_polygon_assign_storage(polygon, storage, capacity);
+  polygon->storage_inline = false;
+  return true;
+}
+
+/**
+ * Point a polygon's `points`, `calc_points`, `edges`, `normals`,
+ * `local_normals`, `normal_extents`, and `normal_twins` into a block of
+ * storage with room for `capacity` points.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon.
+ * @param storage the block of storage.
+ * @param capacity the number of points the storage can hold.
+ */
+void _satc_polygon_assign_storage (satc_polygon_t *polygon, SATC_REAL *storage, size_t capacity) {
+  polygon->storage = storage;
+  polygon->capacity = capacity;
+  polygon->points.x = storage;
+  polygon->points.y = storage + capacity;
+  polygon->calc_points.x = storage + capacity * 2;
+  polygon->calc_points.y = storage + capacity * 3;
+  polygon->edges.x = storage + capacity * 4;
+  polygon->edges.y = storage + capacity * 5;
+  polygon->normals.x = storage + capacity * 6;
+  polygon->normals.y = storage + capacity * 7;
+  polygon->local_normals.x = storage + capacity * 8;
+  polygon->local_normals.y = storage + capacity * 9;
+  polygon->normal_extents.x = storage + capacity * 10;
+  polygon->normal_extents.y = storage + capacity * 11;
+  polygon->normal_twins = (size_t *) (storage + capacity * 12);
+}
+
+/**
+ * Give a polygon with borrowed points its own copy of them, with room for at
+ * least some number of points. Instances release their geometry, and views
+ * stop reading from their buffer. Polygons which already own their points
+ * are left alone.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon.
+ * @param capacity the number of points the new storage must hold.
+ * @return true if the polygon now owns its points, false if its storage could
+ * not be allocated, in which case the polygon is left unchanged.
+ */
+bool _satc_polygon_own_points (satc_polygon_t *polygon, size_t capacity) {
+  if (!polygon->points_borrowed) return true;
+  size_t num_points = polygon->num_points;
+  if (capacity < num_points) capacity = num_points;
+
+  SATC_REAL *storage = NULL;
+  storage = (SATC_REAL *) _satc_alloc(polygon->arena, SATC_ALLOC_POLYGON, sizeof(SATC_REAL) * _satc_polygon_storage_reals(capacity));
+  if (storage == NULL && capacity > 0) return false;
+
+  SATC_REAL *xs = polygon->points.x;
+  SATC_REAL *ys = polygon->points.y;
+  size_t stride = polygon->points_stride;
+  _satc_free(polygon->arena, SATC_ALLOC_POLYGON, polygon->storage);
+  _satc_polygon_assign_storage(polygon, storage, capacity);
+  size_t i = 0;
+  for (; i < num_points; i++) {
+    polygon->points.x[i] = xs[i * stride];
+    polygon->points.y[i] = ys[i * stride];
+  }
+  polygon->num_calc_points = num_points;
+  polygon->num_edges = num_points;
+  polygon->num_normals = num_points;
+  polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES | SATC_POLYGON_DIRTY_LOCAL_NORMALS;
+  polygon->points_stride = 1;
+  polygon->points_borrowed = false;
+  if (polygon->geometry != NULL) satc_geometry_release(polygon->geometry);
+  polygon->geometry = NULL;
+  return true;
+}
+
+/**
+ * Replace a polygon struct's list of points.
+ *
+ * The polygon's storage must already be able to hold `num_points` points. The
+ * calculated values of the polygon will be recalculated.
+ *
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon whose points to replace.
+ * @param num_points the number of new points.
+ * @param points an array of arrays of doubles (array of points).
+ */
+void _satc_polygon_copy_points (satc_polygon_t *polygon, size_t num_points, SATC_REAL **points) {
+  SATC_REAL *xs = polygon->points.x;
+  SATC_REAL *ys = polygon->points.y;
+  size_t i = 0;
+  for (; i < num_points; i++) {
+    xs[i] = satc_point_get_x(points[i]);
+    ys[i] = satc_point_get_y(points[i]);
+  }
+
+  polygon->num_points = num_points;
+  polygon->num_calc_points = num_points;
+  polygon->num_edges = num_points;
+  polygon->num_normals = num_points;
+  polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES | SATC_POLYGON_DIRTY_LOCAL_NORMALS;
+}
+
+/**
+ * Given a polygon and number of points, it will replace the points already on
+ * the polygon, and recalculate all the calculated values.
+ *
+ * The polygon's storage is only reallocated when it is too small to hold the
+ * new points, so replacing points with the same number of points (or fewer)
+ * does not allocate. The calculated values are recalculated the next time
+ * they are needed.
+ *
+ * If the polygon is an instance of shared geometry or a view over a buffer,
+ * it gets its own storage, and stops borrowing its points.
+ *
+ * If the polygon was created in an arena and has to grow, its new storage is
+ * carved out of the arena, and its old storage stays used until the arena is
+ * reset.
+ *
+ * The points passed in are copied, and so you must handle the deallocation of
+ * the passed-in points.
+ *
+ * @param polygon the polygon whose points should be replaced.
+ * @param num_points the number of new points.
+ * @param points an array of arrays of doubles (array of points).
+ * @return the polygon passed in, or `NULL` if the polygon's arena is out of
+ * room for the new points, in which case the polygon is left unchanged.
+ */
+satc_polygon_t *satc_polygon_set_points (satc_polygon_t *polygon, size_t num_points, SATC_REAL **points) {
+  if (!_satc_polygon_own_points(polygon, num_points)) return NULL;
+  if (!_satc_polygon_reserve(polygon, num_points)) return NULL;
+  _satc_polygon_copy_points(polygon, num_points, points);
+  return polygon;
+}
+
+/**
+ * Mark all of a polygon's calculated values as out of date, so they are
+ * recalculated the next time they are needed. Call this after changing the
+ * points of a polygon by hand, or the buffer a view reads its points from.
+ *
+ * @param polygon the polygon.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *satc_polygon_invalidate (satc_polygon_t *polygon) {
+  polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES;
+  // Instances never change their geometry's points, so their local normals stay put.
+  if (polygon->geometry == NULL) polygon->dirty |= SATC_POLYGON_DIRTY_LOCAL_NORMALS;
+  return polygon;
+}
+
+/**
+ * Set the angle of rotation of the polygon. All calculated values will be
+ * recalculated the next time they are needed.
+ *
+ * @param polygon the polygon to rotate.
+ * @param angle the angle to rotate by.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *satc_polygon_set_angle (satc_polygon_t *polygon, SATC_REAL angle) {
+  if (angle == polygon->angle) return polygon;
+  polygon->angle = angle;
+  satc_point_set_xy(polygon->rotation, SATC_COS(angle), SATC_SIN(angle));
+  polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES;
+  return polygon;
+}
+
+/**
+ * Copies the position and angle of a polygon's transform into the polygon, if
+ * the transform has changed since they were last copied.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon to update.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *_satc_polygon_sync_transform (satc_polygon_t *polygon) {
+  satc_transform_t *transform = polygon->transform;
+  if (transform == NULL || polygon->transform_version == transform->version) return polygon;
+  satc_point_copy(polygon->pos, transform->pos);
+  if (transform->angle != polygon->angle) {
+    polygon->angle = transform->angle;
+    satc_point_copy(polygon->rotation, transform->rotation);
+    polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES;
+  }
+  polygon->transform_version = transform->version;
+  return polygon;
+}
+
+/**
+ * Make a polygon follow a shared transform. From then on, the transform's
+ * position and angle replace the polygon's own, and the polygon picks up
+ * changes to the transform the next time it is read. The cosine and sine of
+ * the angle are taken from the transform, so they are only calculated once
+ * for every shape sharing it.
+ *
+ * The transform is not copied, so it must outlive the polygon or be detached
+ * first.
+ *
+ * @param polygon the polygon.
+ * @param transform the transform to follow, or `NULL` to stop following one.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *satc_polygon_set_transform (satc_polygon_t *polygon, satc_transform_t *transform) {
+  polygon->transform = transform;
+  if (transform == NULL) return polygon;
+  // Make sure the next sync copies the transform, whatever its version.
+  polygon->transform_version = transform->version - 1;
+  return _satc_polygon_sync_transform(polygon);
+}
+
+/**
+ * Set the offset of the polygon. The calculated points will be recalculated
+ * the next time they are needed. Since this is only a translation, the edges
+ * and normals are left alone.
+ *
+ * @param polygon the polygon to offset.
+ * @param offset the array of doubles (a point) to offset by.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *satc_polygon_set_offset (satc_polygon_t *polygon, SATC_REAL *offset) {
+  satc_point_copy(polygon->offset, offset);
+  polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS;
+  return polygon;
+}
+
+/**
+ * In lieu of setting the angle of the polygon, you can actually rotate all of
+ * the points. All calculated values will be recalculated the next time they
+ * are needed.
+ *
+ * @param polygon the polygon to offset.
+ * @param angle the array of doubles (a point) to offset by.
+ * @return the passed-in polygon, or `NULL` if its points are borrowed and its
+ * own copy of them could not be allocated.
+ */
+satc_polygon_t *satc_polygon_rotate (satc_polygon_t *polygon, SATC_REAL angle) {
+  if (!_satc_polygon_own_points(polygon, polygon->num_points)) return NULL;
+  SATC_REAL *xs = polygon->points.x;
+  SATC_REAL *ys = polygon->points.y;
+  SATC_REAL c = SATC_COS(angle);
+  SATC_REAL s = SATC_SIN(angle);
+  size_t i = 0;
+  for (; i < polygon->num_points; i++) {
+    satc_vec2_t point = satc_vec2_rotate_cs(satc_vec2(xs[i], ys[i]), c, s);
+    xs[i] = point.x;
+    ys[i] = point.y;
+  }
+  polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS | SATC_POLYGON_DIRTY_EDGES | SATC_POLYGON_DIRTY_LOCAL_NORMALS;
+  return polygon;
+}
+
+/**
+ * In lieu of setting the offset of the polygon, you can actually translate all
+ * of the points by some `x` and `y`. The calculated points will be
+ * recalculated the next time they are needed. Since this is only a
+ * translation, the edges and normals are left alone.
+ *
+ * @param polygon the polygon to offset.
+ * @param x the horizontal amount to translate by.
+ * @param y the vertical amount to translate by.
+ * @return the passed-in polygon, or `NULL` if its points are borrowed and its
+ * own copy of them could not be allocated.
+ */
+satc_polygon_t *satc_polygon_translate (satc_polygon_t *polygon, SATC_REAL x, SATC_REAL y) {
+  if (!_satc_polygon_own_points(polygon, polygon->num_points)) return NULL;
+  SATC_REAL *xs = polygon->points.x;
+  SATC_REAL *ys = polygon->points.y;
+  size_t i = 0;
+  for (; i < polygon->num_points; i++) {
+    xs[i] += x;
+    ys[i] += y;
+  }
+  polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS;
+  return polygon;
+}
+
+/**
+ * Recalculates the calculated points and the bounding box of a struct
+ * representing a polygon shape.
+ *
+ * For internal use.
+ *
+ * @param polygon a polygon whose values should be recalculated.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *_satc_polygon_recalc_points (satc_polygon_t *polygon) {
+  SATC_REAL *xs = polygon->points.x;
+  SATC_REAL *ys = polygon->points.y;
+  SATC_REAL *calc_xs = polygon->calc_points.x;
+  SATC_REAL *calc_ys = polygon->calc_points.y;
+  SATC_REAL offset_x = satc_point_get_x(polygon->offset);
+  SATC_REAL offset_y = satc_point_get_y(polygon->offset);
+  bool rotated = polygon->angle != 0.0;
+  SATC_REAL c = satc_point_get_x(polygon->rotation);
+  SATC_REAL s = satc_point_get_y(polygon->rotation);
+  size_t stride = polygon->points_stride;
+  size_t num_points = polygon->num_points;
+  SATC_REAL min_x = SATC_REAL_MAX;
+  SATC_REAL min_y = SATC_REAL_MAX;
+  SATC_REAL max_x = -SATC_REAL_MAX;
+  SATC_REAL max_y = -SATC_REAL_MAX;
+  size_t i = 0;
+#ifdef SATC_SIMD
+  if (stride == 1 && num_points >= SATC_SIMD_WIDTH) {
+    satc_simd_t v_offset_x = satc_simd_set1(offset_x);
+    satc_simd_t v_offset_y = satc_simd_set1(offset_y);
+    satc_simd_t v_c = satc_simd_set1(c);
+    satc_simd_t v_s = satc_simd_set1(s);
+    satc_simd_t v_min_x = satc_simd_set1(min_x);
+    satc_simd_t v_min_y = satc_simd_set1(min_y);
+    satc_simd_t v_max_x = satc_simd_set1(max_x);
+    satc_simd_t v_max_y = satc_simd_set1(max_y);
+    for (; i + SATC_SIMD_WIDTH <= num_points; i += SATC_SIMD_WIDTH) {
+      satc_simd_t x = satc_simd_add(satc_simd_load(xs + i), v_offset_x);
+      satc_simd_t y = satc_simd_add(satc_simd_load(ys + i), v_offset_y);
+      if (rotated) {
+        satc_simd_t rotated_x = satc_simd_sub(satc_simd_mul(x, v_c), satc_simd_mul(y, v_s));
+        y = satc_simd_add(satc_simd_mul(x, v_s), satc_simd_mul(y, v_c));
+        x = rotated_x;
+      }
+      satc_simd_store(calc_xs + i, x);
+      satc_simd_store(calc_ys + i, y);
+      v_min_x = satc_simd_min(v_min_x, x);
+      v_min_y = satc_simd_min(v_min_y, y);
+      v_max_x = satc_simd_max(v_max_x, x);
+      v_max_y = satc_simd_max(v_max_y, y);
+    }
+    SATC_REAL lanes[4][SATC_SIMD_WIDTH];
+    satc_simd_store(lanes[0], v_min_x);
+    satc_simd_store(lanes[1], v_min_y);
+    satc_simd_store(lanes[2], v_max_x);
+    satc_simd_store(lanes[3], v_max_y);
+    size_t lane = 0;
+    for (; lane < SATC_SIMD_WIDTH; lane++) {
+      if (lanes[0][lane] < min_x) min_x = lanes[0][lane];
+      if (lanes[1][lane] < min_y) min_y = lanes[1][lane];
+      if (lanes[2][lane] > max_x) max_x = lanes[2][lane];
+      if (lanes[3][lane] > max_y) max_y = lanes[3][lane];
+    }
+  }
+#endif
+  for (; i < num_points; i++) {
+    satc_vec2_t calc_point = satc_vec2(xs[i * stride] + offset_x, ys[i * stride] + offset_y);
+    if (rotated) calc_point = satc_vec2_rotate_cs(calc_point, c, s);
+    calc_xs[i] = calc_point.x;
+    calc_ys[i] = calc_point.y;
+    if (calc_point.x < min_x) min_x = calc_point.x;
+    if (calc_point.y < min_y) min_y = calc_point.y;
+    if (calc_point.x > max_x) max_x = calc_point.x;
+    if (calc_point.y > max_y) max_y = calc_point.y;
+  }
+
+  satc_aabb_t *aabb = &polygon->aabb;
+  if (num_points > 0) {
+    satc_point_set_xy(aabb->min, min_x, min_y);
+    satc_point_set_xy(aabb->max, max_x, max_y);
+  } else {
+    satc_point_set_xy(aabb->min, 0.0, 0.0);
+    satc_point_set_xy(aabb->max, 0.0, 0.0);
+  }
+
+  polygon->dirty &= ~SATC_POLYGON_DIRTY_CALC_POINTS;
+  return polygon;
+}
+
+/**
+ * Recalculates the calculated edges and normals of an instance of some shared
+ * geometry, by rotating the geometry's edges and normals. Rotation keeps
+ * their lengths, so no square roots are needed.
+ *
+ * For internal use.
+ *
+ * @param polygon a polygon whose values should be recalculated.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *_satc_polygon_recalc_instance_edges (satc_polygon_t *polygon) {
+  satc_geometry_t *geometry = polygon->geometry;
+  size_t num_points = polygon->num_points;
+  size_t bytes = sizeof(SATC_REAL) * num_points;
+  if (polygon->angle == 0.0) {
+    if (num_points > 0) {
+      memcpy(polygon->edges.x, geometry->edges.x, bytes);
+      memcpy(polygon->edges.y, geometry->edges.y, bytes);
+      memcpy(polygon->normals.x, geometry->normals.x, bytes);
+      memcpy(polygon->normals.y, geometry->normals.y, bytes);
+    }
+  } else {
+    SATC_REAL c = satc_point_get_x(polygon->rotation);
+    SATC_REAL s = satc_point_get_y(polygon->rotation);
+    size_t i = 0;
+    for (; i < num_points; i++) {
+      satc_vec2_t edge = satc_vec2_rotate_cs(satc_vec2(geometry->edges.x[i], geometry->edges.y[i]), c, s);
+      satc_vec2_t normal = satc_vec2_rotate_cs(satc_vec2(geometry->normals.x[i], geometry->normals.y[i]), c, s);
+      polygon->edges.x[i] = edge.x;
+      polygon->edges.y[i] = edge.y;
+      polygon->normals.x[i] = normal.x;
+      polygon->normals.y[i] = normal.y;
+    }
+  }
+
+  polygon->dirty &= ~SATC_POLYGON_DIRTY_EDGES;
+  return polygon;
+}
+
+/**
+ * Returns the length an edge between two calculated points of a polygon
+ * must exceed to have a normal. Rotating two equal points can leave them a
+ * few rounding errors apart, so a shorter edge is treated as having no
+ * length at all.
+ *
+ * For internal use.
+ *
+ * @param polygon a polygon whose bounding box is up to date.
+ * @return the length.
+ */
+SATC_REAL _satc_polygon_min_edge_length (satc_polygon_t *polygon) {
+  satc_aabb_t *aabb = &polygon->aabb;
+  SATC_REAL scale = SATC_FABS(satc_point_get_x(aabb->min));
+  if (SATC_FABS(satc_point_get_y(aabb->min)) > scale) scale = SATC_FABS(satc_point_get_y(aabb->min));
+  if (SATC_FABS(satc_point_get_x(aabb->max)) > scale) scale = SATC_FABS(satc_point_get_x(aabb->max));
+  if (SATC_FABS(satc_point_get_y(aabb->max)) > scale) scale = SATC_FABS(satc_point_get_y(aabb->max));
+  return scale * SATC_REAL_EPSILON * 16;
+}
+
+/**
+ * Recalculates the calculated edges and normals of a struct representing a
+ * polygon shape, from its calculated points. Edges no longer than
+ * `_satc_polygon_min_edge_length` get a zero normal.
+ *
+ * For internal use.
+ *
+ * @param polygon a polygon whose values should be recalculated.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *_satc_polygon_recalc_edges (satc_polygon_t *polygon) {
+  if (polygon->geometry != NULL) return _satc_polygon_recalc_instance_edges(polygon);
+  SATC_REAL *calc_xs = polygon->calc_points.x;
+  SATC_REAL *calc_ys = polygon->calc_points.y;
+  SATC_REAL *edges_x = polygon->edges.x;
+  SATC_REAL *edges_y = polygon->edges.y;
+  SATC_REAL *normals_x = polygon->normals.x;
+  SATC_REAL *normals_y = polygon->normals.y;
+  size_t num_points = polygon->num_points;
+  SATC_REAL min_length = _satc_polygon_min_edge_length(polygon);
+  size_t i = 0;
+#ifdef SATC_SIMD
+  // Every edge but the last one, which wraps around to the first point.
+  satc_simd_t zero = satc_simd_set1(0.0);
+  satc_simd_t v_min_length = satc_simd_set1(min_length);
+  for (; i + SATC_SIMD_WIDTH < num_points; i += SATC_SIMD_WIDTH) {
+    satc_simd_t edge_x = satc_simd_sub(satc_simd_load(calc_xs + i + 1), satc_simd_load(calc_xs + i));
+    satc_simd_t edge_y = satc_simd_sub(satc_simd_load(calc_ys + i + 1), satc_simd_load(calc_ys + i));
+    satc_simd_store(edges_x + i, edge_x);
+    satc_simd_store(edges_y + i, edge_y);
+    satc_simd_t normal_x = edge_y;
+    satc_simd_t normal_y = satc_simd_neg(edge_x);
+    satc_simd_t d = satc_simd_sqrt(satc_simd_add(satc_simd_mul(normal_x, normal_x), satc_simd_mul(normal_y, normal_y)));
+    satc_simd_t nonzero = satc_simd_gt(d, v_min_length);
+    satc_simd_store(normals_x + i, satc_simd_select(nonzero, satc_simd_div(normal_x, d), zero));
+    satc_simd_store(normals_y + i, satc_simd_select(nonzero, satc_simd_div(normal_y, d), zero));
+  }
+#endif
+  for (; i < num_points; i++) {
+    size_t next = (i < num_points - 1) ? i + 1 : 0;
+    satc_vec2_t edge = satc_vec2(calc_xs[next] - calc_xs[i], calc_ys[next] - calc_ys[i]);
+    satc_vec2_t normal = satc_vec2_perp(edge);
+    SATC_REAL d = satc_vec2_len(normal);
+    normal = d > min_length ? satc_vec2(normal.x / d, normal.y / d) : satc_vec2(0.0, 0.0);
+    edges_x[i] = edge.x;
+    edges_y[i] = edge.y;
+    normals_x[i] = normal.x;
+    normals_y[i] = normal.y;
+  }
+
+  polygon->dirty &= ~SATC_POLYGON_DIRTY_EDGES;
+  return polygon;
+}
+
+/**
+ * Recalculates all the calculated values for a struct representing a polygon
+ * shape, whether or not they are out of date.
+ *
+ * For internal use.
+ *
+ * @param polygon a polygon whose values should be recalculated.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *_satc_polygon_recalc (satc_polygon_t *polygon) {
+  _satc_polygon_recalc_points(polygon);
+  _satc_polygon_recalc_edges(polygon);
+  return polygon;
+}
+
+/**
+ * Allocate the calculated points, edges, and normals of an instance of some
+ * shared geometry, which are left out until they are first needed.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon.
+ * @return true if the calculated values were allocated, false otherwise.
+ */
+bool _satc_polygon_reserve_instance (satc_polygon_t *polygon) {
+  size_t num_points = polygon->num_points;
+  SATC_REAL *storage = NULL;
+  storage = (SATC_REAL *) _satc_alloc(polygon->arena, SATC_ALLOC_POLYGON, sizeof(SATC_REAL) * num_points * 6);
+  if (storage == NULL) return false;
+
+  polygon->storage = storage;
+  polygon->calc_points.x = storage;
+  polygon->calc_points.y = storage + num_points;
+  polygon->edges.x = storage + num_points * 2;
+  polygon->edges.y = storage + num_points * 3;
+  polygon->normals.x = storage + num_points * 4;
+  polygon->normals.y = storage + num_points * 5;
+  polygon->num_calc_points = num_points;
+  polygon->num_edges = num_points;
+  polygon->num_normals = num_points;
+  return true;
+}
+
+/**
+ * Brings the calculated values of a polygon up to date, recalculating only
+ * what has changed since they were last calculated. After a translation, only
+ * the calculated points and bounding box are recalculated.
+ *
+ * If the polygon follows a transform, any changes to the transform are picked
+ * up first.
+ *
+ * Every function which reads the calculated values calls this for you, so you
+ * only need it when reading them directly.
+ *
+ * @param polygon the polygon to update.
+ * @return the passed-in polygon, or `NULL` if it is an instance of shared
+ * geometry whose calculated values could not be allocated, in which case it
+ * is treated as having no points.
+ */
+satc_polygon_t *satc_polygon_update (satc_polygon_t *polygon) {
+  _satc_polygon_sync_transform(polygon);
+  if (polygon->geometry != NULL && polygon->storage == NULL && !_satc_polygon_reserve_instance(polygon)) return NULL;
+  if (polygon->dirty & SATC_POLYGON_DIRTY_LOCAL_NORMALS) _satc_polygon_recalc_local(polygon);
+  if (polygon->dirty & SATC_POLYGON_DIRTY_CALC_POINTS) _satc_polygon_recalc_points(polygon);
+  if (polygon->dirty & SATC_POLYGON_DIRTY_EDGES) _satc_polygon_recalc_edges(polygon);
+  return polygon;
+}
+
+/**
+ * Recalculates the local normals of a struct representing a polygon shape,
+ * from its untransformed points, along with the twins among them and the
+ * extent of the points along each of them.
+ *
+ * For internal use.
+ *
+ * @param polygon a polygon whose values should be recalculated.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *_satc_polygon_recalc_local (satc_polygon_t *polygon) {
+  SATC_REAL *xs = polygon->points.x;
+  SATC_REAL *ys = polygon->points.y;
+  size_t stride = polygon->points_stride;
+  size_t num_points = polygon->num_points;
+  size_t i = 0;
+  for (; i < num_points; i++) {
+    size_t next = (i < num_points - 1) ? i + 1 : 0;
+    satc_vec2_t edge = satc_vec2(xs[next * stride] - xs[i * stride], ys[next * stride] - ys[i * stride]);
+    satc_vec2_t normal = satc_vec2_normalize(satc_vec2_perp(edge));
+    polygon->local_normals.x[i] = normal.x;
+    polygon->local_normals.y[i] = normal.y;
+  }
+  polygon->num_axes = _satc_find_normal_twins(num_points, &polygon->local_normals, polygon->normal_twins);
+  polygon->convex = _satc_points_are_convex(num_points, xs, ys, stride);
+  polygon->normal_turn = _satc_find_normal_turn(num_points, &polygon->local_normals, polygon->convex);
+  _satc_find_normal_extents(num_points, xs, ys, stride, &polygon->local_normals, polygon->normal_twins, polygon->convex, &polygon->normal_extents);
+
+  polygon->dirty &= ~SATC_POLYGON_DIRTY_LOCAL_NORMALS;
+  return polygon;
+}
+
+/**
+ * Recalculates the local normals of a struct representing a polygon shape,
+ * if they are out of date. Also picks up any changes to the polygon's
+ * transform. The calculated points, edges, and normals are left alone.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon to update.
+ * @return the passed-in polygon.
+ */
+satc_polygon_t *_satc_polygon_update_local (satc_polygon_t *polygon) {
+  _satc_polygon_sync_transform(polygon);
+  if (polygon->dirty & SATC_POLYGON_DIRTY_LOCAL_NORMALS) _satc_polygon_recalc_local(polygon);
+  return polygon;
+}
+
+/**
+ * Pair up the twins among a polygon's normals: normals lying along the same
+ * axis but facing opposite ways. See `satc_polygon_t`.
+ *
+ * The normals of a convex polygon turn steadily as they go around it, so a
+ * normal's twin is the first one at least half a turn further along. A second
+ * index is kept that far ahead of the first, so this takes linear time. Only
+ * normals which really are opposite (up to rounding) are paired, so the twins
+ * are always correct, though some of them may be missed on concave polygons.
+ *
+ * For internal use.
+ *
+ * @param num_normals the number of normals.
+ * @param normals the unit normals, as a structure of arrays.
+ * @param twins the array of `num_normals` indices to fill in.
+ * @return the number of distinct axes among the normals.
+ */
+size_t _satc_find_normal_twins (size_t num_normals, satc_points_t *normals, size_t *twins) {
+  SATC_REAL *xs = normals->x;
+  SATC_REAL *ys = normals->y;
+  size_t num_axes = num_normals;
+  size_t i = 0;
+  for (; i < num_normals; i++) twins[i] = i;
+  if (num_normals < 2) return num_axes;
+
+  // Whether the normals turn clockwise or counter-clockwise.
+  SATC_REAL turn = 0.0;
+  for (i = 0; i < num_normals; i++) {
+    size_t next = (i < num_normals - 1) ? i + 1 : 0;
+    turn += xs[i] * ys[next] - ys[i] * xs[next];
+  }
+  turn = turn < 0.0 ? -1.0 : 1.0;
+  // Unit normals this close to parallel are treated as lying along one axis.
+  SATC_REAL epsilon = SATC_REAL_EPSILON * 8;
+
+  size_t ahead = 1;
+  for (i = 0; i < num_normals; i++) {
+    if (ahead == 0) ahead = 1;
+    // Skip the normals less than half a turn further along, and any empty ones.
+    for (; ahead < num_normals; ahead++) {
+      size_t j = (i + ahead) % num_normals;
+      SATC_REAL cross = xs[i] * ys[j] - ys[i] * xs[j];
+      SATC_REAL dot = xs[i] * xs[j] + ys[i] * ys[j];
+      bool empty = xs[j] == 0.0 && ys[j] == 0.0;
+      if (!empty && cross * turn <= epsilon && (SATC_FABS(cross) > epsilon || dot <= 0.0)) break;
+    }
+    if (ahead < num_normals) {
+      size_t j = (i + ahead) % num_normals;
+      SATC_REAL cross = xs[i] * ys[j] - ys[i] * xs[j];
+      SATC_REAL dot = xs[i] * xs[j] + ys[i] * ys[j];
+      if (SATC_FABS(cross) <= epsilon && dot < 0.0 && twins[i] == i && twins[j] == j) {
+        twins[i] = j;
+        twins[j] = i;
+        num_axes--;
+      }
+    }
+    ahead--;
+  }
+
+  return num_axes;
+}
+
+/**
+ * Figure out whether some points make up a convex polygon: every corner turns
+ * the same way, and the edges only go around once.
+ *
+ * Edges of zero length, from repeated points, are skipped, so each corner is
+ * measured between the edges on either side of it which have a length. An
+ * edge which turns straight back along the one before it is not convex.
+ *
+ * For internal use.
+ *
+ * @param num_points the number of points.
+ * @param xs the first `x` value.
+ * @param ys the first `y` value.
+ * @param stride the distance from one value to the next, counted in
+ * `SATC_REAL` values.
+ * @return whether the polygon is convex, as a boolean.
+ */
+bool _satc_points_are_convex (size_t num_points, SATC_REAL *xs, SATC_REAL *ys, size_t stride) {
+  if (num_points < 3) return true;
+  // The last edge with a length comes before the first one, going around.
+  SATC_REAL last_edge_x = 0.0;
+  SATC_REAL last_edge_y = 0.0;
+  size_t i = num_points;
+  while (i > 0 && last_edge_x == 0.0 && last_edge_y == 0.0) {
+    i--;
+    size_t next = (i + 1) % num_points;
+    last_edge_x = xs[next * stride] - xs[i * stride];
+    last_edge_y = ys[next * stride] - ys[i * stride];
+  }
+  // Every point is the same.
+  if (last_edge_x == 0.0 && last_edge_y == 0.0) return true;
+
+  int turn = 0;
+  // The signs of the first and latest non-zero edge components, and how often they flip.
+  int first_x = 0;
+  int first_y = 0;
+  int last_x = 0;
+  int last_y = 0;
+  int flips_x = 0;
+  int flips_y = 0;
+  for (i = 0; i < num_points; i++) {
+    size_t next = (i + 1) % num_points;
+    SATC_REAL edge_x = xs[next * stride] - xs[i * stride];
+    SATC_REAL edge_y = ys[next * stride] - ys[i * stride];
+    if (edge_x == 0.0 && edge_y == 0.0) continue;
+    SATC_REAL cross = last_edge_x * edge_y - last_edge_y * edge_x;
+    int corner = cross > 0.0 ? 1 : (cross < 0.0 ? -1 : 0);
+    if (corner != 0) {
+      if (turn != 0 && corner != turn) return false;
+      turn = corner;
+    } else if (last_edge_x * edge_x + last_edge_y * edge_y < 0.0) {
+      return false;
+    }
+    last_edge_x = edge_x;
+    last_edge_y = edge_y;
+
+    int sign_x = edge_x > 0.0 ? 1 : (edge_x < 0.0 ? -1 : 0);
+    int sign_y = edge_y > 0.0 ? 1 : (edge_y < 0.0 ? -1 : 0);
+    if (sign_x != 0) {
+      if (first_x == 0) first_x = sign_x;
+      if (last_x != 0 && sign_x != last_x) flips_x++;
+      last_x = sign_x;
+    }
+    if (sign_y != 0) {
+      if (first_y == 0) first_y = sign_y;
+      if (last_y != 0 && sign_y != last_y) flips_y++;
+      last_y = sign_y;
+    }
+  }
+  if (last_x != first_x) flips_x++;
+  if (last_y != first_y) flips_y++;
+  return flips_x <= 2 && flips_y <= 2;
+}
+
+/**
+ * Figure out which way the normals of a convex polygon turn as they go
+ * around it. See `satc_polygon_t`.
+ *
+ * For internal use.
+ *
+ * @param num_normals the number of normals.
+ * @param normals the unit normals, as a structure of arrays.
+ * @param convex whether the points make up a convex polygon.
+ * @return `1` if the normals turn counter-clockwise, `-1` if they turn
+ * clockwise, or `0` if they can not be searched.
+ */
+int _satc_find_normal_turn (size_t num_normals, satc_points_t *normals, bool convex) {
+  if (!convex || num_normals < 3) return 0;
+  SATC_REAL *xs = normals->x;
+  SATC_REAL *ys = normals->y;
+  SATC_REAL turn = 0.0;
+  size_t i = 0;
+  for (; i < num_normals; i++) {
+    // An empty edge has no direction to sort by.
+    if (xs[i] == 0.0 && ys[i] == 0.0) return 0;
+    size_t next = (i < num_normals - 1) ? i + 1 : 0;
+    turn += xs[i] * ys[next] - ys[i] * xs[next];
+  }
+  if (turn == 0.0) return 0;
+  return turn < 0.0 ? -1 : 1;
+}
+
+/**
+ * Find the smallest and largest projections of a polygon's points onto each
+ * of its normals. See `satc_polygon_t`.
+ *
+ * A normal's own edge lies at one end of its range. On a convex polygon, the
+ * far end is found by walking from the far end of the previous normal's
+ * range, which only ever moves forward, so this takes linear time. Other
+ * polygons project every point onto every normal. Twins reuse each other's
+ * ranges, reversed.
+ *
+ * For internal use.
+ *
+ * @param num_points the number of points.
+ * @param xs the first `x` value.
+ * @param ys the first `y` value.
+ * @param stride the distance from one value to the next, counted in
+ * `SATC_REAL` values.
+ * @param normals the unit normals of the edges, as a structure of arrays.
+ * @param twins the twins among the normals.
+ * @param convex whether the points make up a convex polygon.
+ * @param extents the structure of arrays to fill with the ranges.
+ */
+void _satc_find_normal_extents (size_t num_points, SATC_REAL *xs, SATC_REAL *ys, size_t stride, satc_points_t *normals, size_t *twins, bool convex, satc_points_t *extents) {
+  satc_real_array_alloca(range, 2);
+  satc_point_alloca(normal);
+  size_t far = 2;
+  size_t i = 0;
+  for (; i < num_points; i++) {
+    size_t twin = twins[i];
+    if (twin < i) {
+      extents->x[i] = -extents->y[twin];
+      extents->y[i] = -extents->x[twin];
+    } else if (!convex || num_points < 4 || (normals->x[i] == 0.0 && normals->y[i] == 0.0)) {
+      satc_point_set_xy(normal, normals->x[i], normals->y[i]);
+      _satc_flatten_strided_points_on(num_points, xs, ys, stride, normal, range);
+      extents->x[i] = range[0];
+      extents->y[i] = range[1];
+    } else {
+      SATC_REAL nx = normals->x[i];
+      SATC_REAL ny = normals->y[i];
+      size_t next = (i + 1) % num_points;
+      SATC_REAL edge = xs[i * stride] * nx + ys[i * stride] * ny;
+      SATC_REAL edge_end = xs[next * stride] * nx + ys[next * stride] * ny;
+      // Walk away from the edge for as long as the points keep getting further from it.
+      if (far < 2) far = 2;
+      size_t j = (i + far) % num_points;
+      SATC_REAL dot = xs[j * stride] * nx + ys[j * stride] * ny;
+      for (; far + 1 < num_points; far++) {
+        size_t k = (j + 1) % num_points;
+        SATC_REAL next_dot = xs[k * stride] * nx + ys[k * stride] * ny;
+        if (SATC_FABS(next_dot - edge) < SATC_FABS(dot - edge)) break;
+        j = k;
+        dot = next_dot;
+      }
+      SATC_REAL min = edge < edge_end ? edge : edge_end;
+      SATC_REAL max = edge < edge_end ? edge_end : edge;
+      extents->x[i] = dot < min ? dot : min;
+      extents->y[i] = dot > max ? dot : max;
+    }
+    if (far > 0) far--;
+  }
+}
+
+/**
+ * Set the angles and offsets of many polygons at once, and bring all of their
+ * calculated values up to date in a single pass, instead of recalculating
+ * each polygon lazily when it is first tested.
+ *
+ * Each polygon's points are recalculated with SIMD when it is available. As
+ * with `satc_polygon_set_angle`, unchanged angles cost no trig, and polygons
+ * whose angle did not change skip their edges and normals entirely. Polygons
+ * following a transform take its position and angle instead, so their
+ * entries in `angles` are ignored.
+ *
+ * @param count the number of polygons.
+ * @param polygons an array of `count` polygons.
+ * @param angles an array of `count` angles, or `NULL` to leave the angles
+ * alone. The angles of polygons following a transform are ignored.
+ * @param offsets a structure of arrays holding `count` offsets, or `NULL` to
+ * leave the offsets alone.
+ */
+void satc_polygon_update_batch (size_t count, satc_polygon_t **polygons, SATC_REAL *angles, satc_points_t *offsets) {
+  size_t i = 0;
+  for (; i < count; i++) {
+    satc_polygon_t *polygon = polygons[i];
+    if (angles != NULL && polygon->transform == NULL) satc_polygon_set_angle(polygon, angles[i]);
+    if (offsets != NULL) {
+      satc_point_set_xy(polygon->offset, offsets->x[i], offsets->y[i]);
+      polygon->dirty |= SATC_POLYGON_DIRTY_CALC_POINTS;
+    }
+    satc_polygon_update(polygon);
+  }
+}
+
+/**
+ * Get the bounding box of a polygon, in world space, from its cached bounding
+ * box. Nothing is allocated. An empty polygon has a zero-size bounding box at
+ * its position.
+ *
+ * @param polygon the polygon whose bounding box should be calculated.
+ * @param aabb the bounding box to fill in.
+ * @return the passed-in bounding box.
+ */
+satc_aabb_t *satc_polygon_get_bounds (satc_polygon_t *polygon, satc_aabb_t *aabb) {
+  satc_polygon_update(polygon);
+  SATC_REAL x = satc_point_get_x(polygon->pos);
+  SATC_REAL y = satc_point_get_y(polygon->pos);
+  satc_point_set_xy(aabb->min, satc_point_get_x(polygon->aabb.min) + x, satc_point_get_y(polygon->aabb.min) + y);
+  satc_point_set_xy(aabb->max, satc_point_get_x(polygon->aabb.max) + x, satc_point_get_y(polygon->aabb.max) + y);
+  return aabb;
+}
+
+/**
+ * Returns a polygon struct representing the bounding box of a polygon, inside
+ * of an arena.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param polygon the polygon whose bounding box should be calculated.
+ * @return a polygon representing the bounding box, or `NULL` if the arena is
+ * out of room.
+ */
+satc_polygon_t *satc_polygon_get_aabb_in (satc_arena_t *arena, satc_polygon_t *polygon) {
+  satc_aabb_t aabb;
+  satc_polygon_get_bounds(polygon, &aabb);
+  satc_box_t box;
+  box.type = satc_type_box;
+  satc_point_copy(box.pos, aabb.min);
+  box.w = satc_point_get_x(aabb.max) - satc_point_get_x(aabb.min);
+  box.h = satc_point_get_y(aabb.max) - satc_point_get_y(aabb.min);
+  return satc_box_to_polygon_in(arena, &box);
+}
+
+/**
+ * Returns a polygon struct representing the bounding box of a polygon.
+ *
+ * You are responsible for deallocating the returned polygon.
+ *
+ * @param polygon the polygon whose bounding box should be calculated.
+ * @return a polygon representing the bounding box.
+ */
+satc_polygon_t *satc_polygon_get_aabb (satc_polygon_t *polygon) {
+  return satc_polygon_get_aabb_in(NULL, polygon);
+}
+
+/**
+ * Get the "centroid" (the estimated center) of a polygon as an array of
+ * doubles (a point).
+ *
+ * You are responsible for deallocating the point.
+ *
+ * @param polygon the polygon whose centroid should be calculated.
+ * Degenerate polygons with zero area fall back to the arithmetic mean of
+ * their calculated points.
+ *
+ * @return an array of doubles (a point) representing the centroid.
+ */
+SATC_REAL *satc_polygon_get_centroid (satc_polygon_t *polygon) {
+  satc_polygon_update(polygon);
+  SATC_REAL *xs = polygon->calc_points.x;
+  SATC_REAL *ys = polygon->calc_points.y;
+  size_t len = polygon->num_calc_points;
+  if (len == 0) return satc_point_clone(polygon->pos);
+  SATC_REAL cx = 0.0;
+  SATC_REAL cy = 0.0;
+  SATC_REAL ar = 0.0;
+  size_t i = 0;
+  for (; i < len; i++) {
+    size_t next = (i == len - 1) ? 0 : i + 1;
+    SATC_REAL a = xs[i] * ys[next] - xs[next] * ys[i];
+    cx += (xs[i] + xs[next]) * a;
+    cy += (ys[i] + ys[next]) * a;
+    ar += a;
+  }
+
+  if (SATC_FABS(ar) <= SATC_REAL_EPSILON) {
+    cx = 0.0;
+    cy = 0.0;
+
+    i = 0;
+    for (; i < len; i++) {
+      cx += xs[i];
+      cy += ys[i];
+    }
+
+    cx = cx / len;
+    cy = cy / len;
+  } else {
+    ar = ar * 3.0;
+    cx = cx / ar;
+    cy = cy / ar;
+  }
+
+  return satc_point_create(cx, cy);
+}
+
+/**
+ * Creates a struct representing a box shape, inside of an arena.
+ *
+ * The box is released along with the rest of the arena, and must not be passed
+ * to `satc_box_destroy`.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param pos the position of the box, from the top left.
+ * @param w the width of the box.
+ * @param h the height of the box.
+ * @return a box struct, or `NULL` if the arena is out of room.
+ */
+satc_box_t *satc_box_create_in (satc_arena_t *arena, SATC_REAL *pos, SATC_REAL w, SATC_REAL h) {
+  satc_box_t *box = NULL;
+  box = (satc_box_t *) _satc_alloc(arena, SATC_ALLOC_BOX, sizeof(satc_box_t));
+  if (box == NULL) return NULL;
+  box->type = satc_type_box;
+  satc_point_copy(box->pos, pos);
+  box->w = w;
+  box->h = h;
+  return box;
+}
+
+/**
+ * Creates a struct representing a box shape.
+ *
+ * @param pos the position of the box, from the top left.
+ * @param w the width of the box.
+ * @param h the height of the box.
+ * @return a box struct.
+ */
+satc_box_t *satc_box_create (SATC_REAL *pos, SATC_REAL w, SATC_REAL h) {
+  return satc_box_create_in(NULL, pos, w, h);
+}
+
+/**
+ * Deallocates a struct representing a box shape.
+ *
+ * @param box the box to deallocate.
+ */
+void satc_box_destroy (satc_box_t *box) {
+  box->type = satc_type_none;
+  box->w = -1.0;
+  box->h = -1.0;
+  _satc_free(NULL, SATC_ALLOC_BOX, box);
+}
+
+/**
+ * Returns a polygon representing the box, inside of an arena. It is a small
+ * polygon, so the polygon and its points are a single block of memory.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @param box the box to generate a polygon of.
+ * @return a polygon representing the box, or `NULL` if the arena is out of
+ * room.
+ */
+satc_polygon_t *satc_box_to_polygon_in (satc_arena_t *arena, satc_box_t *box) {
+  satc_small_polygon_t *small = NULL;
+  small = (satc_small_polygon_t *) _satc_alloc(arena, SATC_ALLOC_POLYGON, sizeof(satc_small_polygon_t));
+  if (small == NULL) return NULL;
+  satc_polygon_t *polygon = satc_box_to_small_polygon(box, small);
+  polygon->arena = arena;
+  polygon->embedded = false;
+  return polygon;
+}
+
+/**
+ * Sets up a small polygon representing the box, without allocating anything.
+ * See `satc_small_polygon_init`.
+ *
+ * @param box the box to generate a polygon of.
+ * @param small the small polygon to set up.
+ * @return the polygon inside of `small`.
+ */
+satc_polygon_t *satc_box_to_small_polygon (satc_box_t *box, satc_small_polygon_t *small) {
+  SATC_REAL *pos = box->pos;
+  SATC_REAL w = box->w;
+  SATC_REAL h = box->h;
+  SATC_REAL **points = NULL;
+  points = (SATC_REAL **) alloca(sizeof(SATC_REAL *) * 4);
+  satc_point_alloca(nw);
+  satc_point_alloca(ne);
+  satc_point_alloca(se);
+  satc_point_alloca(sw);
+  satc_point_set_xy(nw, 0.0, 0.0);
+  satc_point_set_xy(ne, w, 0.0);
+  satc_point_set_xy(se, w, h);
+  satc_point_set_xy(sw, 0.0, h);
+  points[0] = nw;
+  points[1] = ne;
+  points[2] = se;
+  points[3] = sw;
+  return satc_small_polygon_init(small, pos, 4, points);
+}
+
+/**
+ * Returns a polygon representing the box.
+ *
+ * You are responsible for deallocating the polygon.
+ *
+ * @param box the box to generate a polygon of.
+ * @return a polygon representing the box.
+ */
+satc_polygon_t *satc_box_to_polygon (satc_box_t *box) {
+  return satc_box_to_polygon_in(NULL, box);
+}
+
+/**
+ * Initializes a collision response which lives on the stack, inside of some
+ * other struct, or in an array. It does not allocate anything, and the
+ * response does not need to be deallocated.
+ *
+ * @param response the response to initialize.
+ * @return the initialized response.
+ */
+satc_response_t *satc_response_init (satc_response_t *response) {
+  response->a = NULL;
+  response->b = NULL;
+  response->overlap = SATC_REAL_MAX;
+  satc_point_set_xy(response->overlap_n, 0.0, 0.0);
+  satc_point_set_xy(response->overlap_v, 0.0, 0.0);
+  response->a_in_b = true;
+  response->b_in_a = true;
+  return response;
+}
+
+/**
+ * Initializes a contiguous array of collision responses, such as a batch of
+ * results. It does not allocate anything.
+ *
+ * @param count the number of responses in the array.
+ * @param responses the array of responses to initialize.
+ * @return the initialized array.
+ */
+satc_response_t *satc_response_init_array (size_t count, satc_response_t *responses) {
+  size_t i = 0;
+  for (; i < count; i++) satc_response_init(&responses[i]);
+  return responses;
+}
+
+/**
+ * Creates a struct representing a collision response, inside of an arena.
+ *
+ * The response is released along with the rest of the arena, and must not be
+ * passed to `satc_response_destroy`.
+ *
+ * @param arena the arena to allocate from, or `NULL` to use the heap.
+ * @return a struct representing a collision response, or `NULL` if the arena
+ * is out of room.
+ */
+satc_response_t *satc_response_create_in (satc_arena_t *arena) {
+  satc_response_t *response = NULL;
+  response = (satc_response_t *) _satc_alloc(arena, SATC_ALLOC_RESPONSE, sizeof(satc_response_t));
+  if (response == NULL) return NULL;
+  return satc_response_init(response);
+}
+
+/**
+ * Creates a struct representing a collision response. This is a single
+ * allocation, since the vectors in a response are stored inline. If you do not
+ * need the response on the heap, declare one and use `satc_response_init` or
+ * `SATC_RESPONSE_INIT` instead.
+ *
+ * Instead of setting the values manually, you should use a `satc_test_*`
+ * function, which will set the values for you.
+ *
+ * @return a struct representing a collision response.
+ */
+satc_response_t *satc_response_create () {
+  return satc_response_create_in(NULL);
+}
+
+/**
+ * Resets a collision response so it can be reused safely. It does not
+ * allocate anything.
+ *
+ * @param response the response to reset.
+ * @return the reset response.
+ */
+satc_response_t *satc_response_clear (satc_response_t *response) {
+  return satc_response_init(response);
+}
+
+/**
+ * Deallocates a struct representing a collision response.
+ *
+ * `response->a` and `response->b` are not deallocated for you!
+ *
+ * @param response the response to deallocate.
+ */
+void satc_response_destroy (satc_response_t *response) {
+  response->a = NULL;
+  response->b = NULL;
+  response->overlap = SATC_REAL_MAX;
+  response->a_in_b = true;
+  response->b_in_a = true;
+  _satc_free(NULL, SATC_ALLOC_RESPONSE, response);
+}
+
+/**
+ * Project a structure of arrays of points onto an axis.
+ *
+ * @param len the number of points.
+ * @param points the structure of arrays of points to project.
+ * @param normal the array of doubles (a point) of the normal.
+ * @param result the arary of doubles (a point) representing the result.
+ */
+void satc_flatten_points_on (size_t len, satc_points_t *points, SATC_REAL *normal, SATC_REAL *result) {
+  SATC_REAL *xs = points->x;
+  SATC_REAL *ys = points->y;
+  SATC_REAL nx = satc_point_get_x(normal);
+  SATC_REAL ny = satc_point_get_y(normal);
+  SATC_REAL min = SATC_REAL_MAX;
+  SATC_REAL max = -SATC_REAL_MAX;
+
+  size_t i = 0;
+#ifdef SATC_SIMD
+  // Reducing the lanes costs more than it saves for a few points.
+  if (len >= SATC_SIMD_WIDTH * 4) {
+    satc_simd_t normal_x = satc_simd_set1(nx);
+    satc_simd_t normal_y = satc_simd_set1(ny);
+    satc_simd_t mins = satc_simd_set1(SATC_REAL_MAX);
+    satc_simd_t maxes = satc_simd_set1(-SATC_REAL_MAX);
+    for (; i + SATC_SIMD_WIDTH <= len; i += SATC_SIMD_WIDTH) {
+      satc_simd_t dot = satc_simd_add(satc_simd_mul(satc_simd_load(xs + i), normal_x), satc_simd_mul(satc_simd_load(ys + i), normal_y));
+      mins = satc_simd_min(mins, dot);
+      maxes = satc_simd_max(maxes, dot);
+    }
+    SATC_REAL lanes[SATC_SIMD_WIDTH * 2];
+    satc_simd_store(lanes, mins);
+    satc_simd_store(lanes + SATC_SIMD_WIDTH, maxes);
+    size_t lane = 0;
+    for (; lane < SATC_SIMD_WIDTH; lane++) {
+      if (lanes[lane] < min) min = lanes[lane];
+      if (lanes[SATC_SIMD_WIDTH + lane] > max) max = lanes[SATC_SIMD_WIDTH + lane];
+    }
+  }
+#endif
+  for (; i < len; i++) {
+    SATC_REAL dot = xs[i] * nx + ys[i] * ny;
+    if (dot < min) min = dot;
+    if (dot > max) max = dot;
+  }
+
+  result[0] = min;
+  result[1] = max;
+}
+
+/**
+ * Project a structure of arrays of points onto a batch of up to
+ * `SATC_AXIS_BATCH` axes at once, and check the projections against a range
+ * for each axis. With `SATC_SIMD_AXES`, each point is projected onto every
+ * axis of the batch with a single multiply and add, and the ranges are
+ * checked without branching. Batches less than half full are projected one
+ * axis at a time.
+ *
+ * For internal use.
+ *
+ * @param len the number of points.
+ * @param points the structure of arrays of points to project.
+ * @param count the number of axes in the batch.
+ * @param axes_x the `x` values of the axes, with room for `SATC_AXIS_BATCH`.
+ * Unused lanes are filled in.
+ * @param axes_y the `y` values of the axes, with room for `SATC_AXIS_BATCH`.
+ * Unused lanes are filled in.
+ * @param shifts the amount to move each projection by.
+ * @param ranges_min the smallest value of the range to check each projection
+ * against.
+ * @param ranges_max the largest value of the range to check each projection
+ * against.
+ * @param mins the array to fill with the smallest value of each projection.
+ * @param maxes the array to fill with the largest value of each projection.
+ * @return whether any projection is separated from its range, as a boolean.
+ */
+bool _satc_flatten_points_on_axes (size_t len, satc_points_t *points, size_t count, SATC_REAL *axes_x, SATC_REAL *axes_y, SATC_REAL *shifts, SATC_REAL *ranges_min, SATC_REAL *ranges_max, SATC_REAL *mins, SATC_REAL *maxes) {
+  size_t k = 0;
+#ifdef SATC_SIMD_AXES
+  // A batch which is mostly empty is quicker to project one axis at a time.
+  if (count * 2 > SATC_AXIS_BATCH) {
+    SATC_REAL *xs = points->x;
+    SATC_REAL *ys = points->y;
+    // Repeat the first axis in the unused lanes.
+    for (k = count; k < SATC_AXIS_BATCH; k++) {
+      axes_x[k] = axes_x[0];
+      axes_y[k] = axes_y[0];
+      shifts[k] = shifts[0];
+      ranges_min[k] = ranges_min[0];
+      ranges_max[k] = ranges_max[0];
+    }
+    satc_simd_t normal_x = satc_simd_load(axes_x);
+    satc_simd_t normal_y = satc_simd_load(axes_y);
+    satc_simd_t min = satc_simd_set1(SATC_REAL_MAX);
+    satc_simd_t max = satc_simd_set1(-SATC_REAL_MAX);
+    size_t i = 0;
+    for (; i < len; i++) {
+      satc_simd_t dot = satc_simd_add(satc_simd_mul(satc_simd_set1(xs[i]), normal_x), satc_simd_mul(satc_simd_set1(ys[i]), normal_y));
+      min = satc_simd_min(min, dot);
+      max = satc_simd_max(max, dot);
+    }
+    satc_simd_t shift = satc_simd_load(shifts);
+    min = satc_simd_add(min, shift);
+    max = satc_simd_add(max, shift);
+    satc_simd_store(mins, min);
+    satc_simd_store(maxes, max);
+    satc_simd_t gap = satc_simd_or(satc_simd_gt(min, satc_simd_load(ranges_max)), satc_simd_gt(satc_simd_load(ranges_min), max));
+    return satc_simd_any(gap);
+  }
+#endif
+  bool separated = false;
+  satc_point_alloca(axis);
+  satc_real_array_alloca(range, 2);
+  for (; k < count; k++) {
+    satc_point_set_xy(axis, axes_x[k], axes_y[k]);
+    satc_flatten_points_on(len, points, axis, range);
+    mins[k] = range[0] + shifts[k];
+    maxes[k] = range[1] + shifts[k];
+    if (mins[k] > ranges_max[k] || ranges_min[k] > maxes[k]) separated = true;
+  }
+  return separated;
+}
+
+/**
+ * Like `satc_flatten_points_on`, but for `x` and `y` values which are some
+ * number of doubles apart, such as those in an interleaved buffer.
+ *
+ * For internal use.
+ *
+ * @param len the number of points.
+ * @param xs the first `x` value.
+ * @param ys the first `y` value.
+ * @param stride the distance from one value to the next, counted in
+ * `SATC_REAL` values.
+ * @param normal the normal to flatten onto, as an array of doubles (a point).
+ * @param result the array of two doubles to store the minimum and maximum in.
+ */
+void _satc_flatten_strided_points_on (size_t len, SATC_REAL *xs, SATC_REAL *ys, size_t stride, SATC_REAL *normal, SATC_REAL *result) {
+  SATC_REAL nx = satc_point_get_x(normal);
+  SATC_REAL ny = satc_point_get_y(normal);
+  SATC_REAL min = SATC_REAL_MAX;
+  SATC_REAL max = -SATC_REAL_MAX;
+
+  size_t i = 0;
+  for (; i < len; i++) {
+    SATC_REAL dot = xs[i * stride] * nx + ys[i * stride] * ny;
+    if (dot < min) min = dot;
+    if (dot > max) max = dot;
+  }
+
+  result[0] = min;
+  result[1] = max;
+}
+
+/**
+ * Measure how far a vector is turned from a reference vector, as a value
+ * from `0` up to `4` which grows steadily with the angle between them, like
+ * an angle in quarter turns, but without any trig.
+ *
+ * For internal use.
+ *
+ * @param ref_x the `x` value of the reference vector.
+ * @param ref_y the `y` value of the reference vector.
+ * @param x the `x` value of the vector.
+ * @param y the `y` value of the vector.
+ * @param turn `1` to measure counter-clockwise, or `-1` for clockwise.
+ * @return how far the vector is turned from the reference vector.
+ */
+SATC_REAL _satc_pseudo_angle (SATC_REAL ref_x, SATC_REAL ref_y, SATC_REAL x, SATC_REAL y, int turn) {
+  SATC_REAL c = ref_x * x + ref_y * y;
+  SATC_REAL s = (ref_x * y - ref_y * x) * turn;
+  SATC_REAL sum = SATC_FABS(c) + SATC_FABS(s);
+  if (sum == 0.0) return 0.0;
+  SATC_REAL t = s / sum;
+  if (c >= 0.0) return t >= 0.0 ? t : 4.0 + t;
+  return 2.0 - t;
+}
+
+/**
+ * Find the point of a convex polygon which lies furthest along a direction.
+ *
+ * The point between two edges is the furthest along every direction between
+ * their normals, and the normals of a convex polygon are sorted by angle, so
+ * the point is found by a binary search of the normals. Rounding can leave
+ * the search a point short, so it then climbs to whichever neighbor lies
+ * further along, until neither does.
+ *
+ * For internal use.
+ *
+ * @param num_points the number of points.
+ * @param xs the first `x` value.
+ * @param ys the first `y` value.
+ * @param stride the distance from one value to the next, counted in
+ * `SATC_REAL` values.
+ * @param normals the unit normals of the edges, as a structure of arrays.
+ * @param turn which way the normals turn. See `satc_polygon_t`.
+ * @param dx the `x` value of the direction.
+ * @param dy the `y` value of the direction.
+ * @return the index of the point.
+ */
+size_t _satc_find_support (size_t num_points, SATC_REAL *xs, SATC_REAL *ys, size_t stride, satc_points_t *normals, int turn, SATC_REAL dx, SATC_REAL dy) {
+  SATC_REAL *nxs = normals->x;
+  SATC_REAL *nys = normals->y;
+  // Normals which turn clockwise face inwards, so they surround the opposite direction.
+  SATC_REAL target = _satc_pseudo_angle(nxs[0], nys[0], dx * turn, dy * turn, turn);
+  // Find the first normal turned further from the first one than the direction.
+  size_t lo = 1;
+  size_t hi = num_points;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (_satc_pseudo_angle(nxs[0], nys[0], nxs[mid], nys[mid], turn) > target) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  size_t best = lo < num_points ? lo : 0;
+
+  SATC_REAL best_dot = xs[best * stride] * dx + ys[best * stride] * dy;
+  size_t steps = 0;
+  for (; steps < num_points; steps++) {
+    size_t next = (best + 1) % num_points;
+    size_t prev = (best + num_points - 1) % num_points;
+    SATC_REAL next_dot = xs[next * stride] * dx + ys[next * stride] * dy;
+    SATC_REAL prev_dot = xs[prev * stride] * dx + ys[prev * stride] * dy;
+    if (next_dot > best_dot) {
+      best = next;
+      best_dot = next_dot;
+    } else if (prev_dot > best_dot) {
+      best = prev;
+      best_dot = prev_dot;
+    } else {
+      break;
+    }
+  }
+  return best;
+}
+
+/**
+ * Like `_satc_flatten_strided_points_on`, but for a convex polygon whose
+ * normals can be searched. The two ends of the range are found with
+ * `_satc_find_support`, so this takes logarithmic time rather than linear.
+ *
+ * For internal use.
+ *
+ * @param len the number of points.
+ * @param xs the first `x` value.
+ * @param ys the first `y` value.
+ * @param stride the distance from one value to the next, counted in
+ * `SATC_REAL` values.
+ * @param normals the unit normals of the edges, as a structure of arrays.
+ * @param turn which way the normals turn. See `satc_polygon_t`.
+ * @param normal the normal to flatten onto, as an array of doubles (a point).
+ * @param result the array of two doubles to store the minimum and maximum in.
+ */
+void _satc_flatten_hull_on (size_t len, SATC_REAL *xs, SATC_REAL *ys, size_t stride, satc_points_t *normals, int turn, SATC_REAL *normal, SATC_REAL *result) {
+  SATC_REAL nx = satc_point_get_x(normal);
+  SATC_REAL ny = satc_point_get_y(normal);
+  size_t min = _satc_find_support(len, xs, ys, stride, normals, turn, -nx, -ny);
+  size_t max = _satc_find_support(len, xs, ys, stride, normals, turn, nx, ny);
+  result[0] = xs[min * stride] * nx + ys[min * stride] * ny;
+  result[1] = xs[max * stride] * nx + ys[max * stride] * ny;
+}
+
+/**
+ * Whether a polygon's range along an axis is found with
+ * `_satc_flatten_hull_on` rather than by projecting every point: it is
+ * convex, its normals can be searched, and it has at least
+ * `SATC_HULL_SEARCH_MIN_POINTS` points.
+ *
+ * For internal use.
+ *
+ * @param polygon a polygon whose local normals are up to date.
+ * @return whether the polygon's normals are searched, as a boolean.
+ */
+bool _satc_polygon_is_hull (satc_polygon_t *polygon) {
+  return polygon->normal_turn != 0 && polygon->num_points >= SATC_HULL_SEARCH_MIN_POINTS;
+}
+
+/**
+ * Figure out if two structures of arrays of points represent a separating
+ * axis.
+ *
+ * Primarily meant for internal use.
+ *
+ * @param a_pos an array of doubles (a point).
+ * @param b_pos an array of doubles (a point).
+ * @param a_len the number of points in `a_points`.
+ * @param a_points a structure of arrays of points.
+ * @param b_len the number of points in `b_points`.
+ * @param b_points a structure of arrays of points.
+ * @param axis the axis as an array of doubles (a point).
+ * @param response the collision response to mutate.
+ * @return whether this represents a separating axis, as a boolean.
+ */
+bool satc_is_separating_axis (SATC_REAL *a_pos, SATC_REAL *b_pos, size_t a_len, satc_points_t *a_points, size_t b_len, satc_points_t *b_points, SATC_REAL *axis, satc_response_t *response) {
+  // Allocate temporary variables.
+  satc_real_array_alloca(range_a, 2);
+  satc_real_array_alloca(range_b, 2);
+  satc_point_alloca(offset_v);
+
+  // The magnitude of the offset between the two polygons.
+  satc_point_copy(offset_v, b_pos);
+  satc_point_sub(offset_v, a_pos);
+  SATC_REAL projected_offset = satc_point_dot(offset_v, axis);
+  // Project the polygons onto the axis.
+  satc_flatten_points_on(a_len, a_points, axis, range_a);
+  satc_flatten_points_on(b_len, b_points, axis, range_b);
+  // Move B's range to its position relative to A.
+  range_b[0] += projected_offset;
+  range_b[1] += projected_offset;
+  return _satc_is_separating_range(range_a, range_b, axis, response);
+}
+
+/**
+ * Figure out if the projections of two shapes onto an axis are separated,
+ * and if not, update the collision response with their overlap.
+ *
+ * For internal use.
+ *
+ * @param range_a the minimum and maximum of the first shape's projection.
+ * @param range_b the minimum and maximum of the second shape's projection,
+ * relative to the first shape's position.
+ * @param axis the axis as an array of doubles (a point).
+ * @param response the collision response to mutate.
+ * @return whether the ranges are separated, as a boolean.
+ */
+bool _satc_is_separating_range (SATC_REAL *range_a, SATC_REAL *range_b, SATC_REAL *axis, satc_response_t *response) {
+  // Check if there is a gap. If there is, this is a separating axis and we can stop.
+  if (range_a[0] > range_b[1] || range_b[0] > range_a[1]) {
+    return true;
+  }
+
+  // This is not a separating axis. If we're calculating a response, calculate the overlap.
+  if (response != NULL) {
+    SATC_REAL overlap = _satc_range_overlap(range_a, range_b, response);
+    // If this is the smallest amount of overlap we've seen so far, set it as the minimum overlap.
+    SATC_REAL abs_overlap = SATC_FABS(overlap);
+    if (abs_overlap < response->overlap) {
+      response->overlap = abs_overlap;
+      satc_point_copy(response->overlap_n, axis);
+      if (overlap < 0) {
+        satc_point_reverse(response->overlap_n);
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Work out how much the projections of two shapes onto an axis overlap, given
+ * that they are not separated, and update whether either shape could be
+ * inside of the other.
+ *
+ * For internal use.
+ *
+ * @param range_a the minimum and maximum of the first shape's projection.
+ * @param range_b the minimum and maximum of the second shape's projection,
+ * relative to the first shape's position.
+ * @param response the collision response to mutate.
+ * @return the overlap, which is negative if `a` has to be pushed back along
+ * the axis.
+ */
+SATC_REAL _satc_range_overlap (SATC_REAL *range_a, SATC_REAL *range_b, satc_response_t *response) {
+  SATC_REAL overlap = 0;
+  // A starts further left than B.
+  if (range_a[0] < range_b[0]) {
+    response->a_in_b = false;
+    // A ends before B does. We have to pull A out of B.
+    if (range_a[1] < range_b[1]) {
+      overlap = range_a[1] - range_b[0];
+      response->b_in_a = false;
+    // B is fully inside A. Pick the shortest way out.
+    } else {
+      SATC_REAL option_1 = range_a[1] - range_b[0];
+      SATC_REAL option_2 = range_b[1] - range_a[0];
+      overlap = option_1 < option_2 ? option_1 : -option_2;
+    }
+  // B starts further left than A.
+  } else {
+    response->b_in_a = false;
+    // B ends before A ends. We have to push A out of B.
+    if (range_a[1] > range_b[1]) {
+      overlap = range_a[0] - range_b[1];
+      response->a_in_b = false;
+    // A is fully inside B.  Pick the shortest way out.
+    } else {
+      SATC_REAL option_1 = range_a[1] - range_b[0];
+      SATC_REAL option_2 = range_b[1] - range_a[0];
+      overlap = option_1 < option_2 ? option_1 : -option_2;
+    }
+  }
+  return overlap;
+}
+
+/**
+ * Like `_satc_is_separating_range`, but for the axis of one of a polygon's
+ * normals and, if it has one, the axis of its twin, which is the same axis
+ * facing the other way. Projections onto the twin are the reverse of the
+ * projections onto the normal, so they are not recalculated.
+ *
+ * The axes can be tested out of order, since twins are tested together. To
+ * get the same response as testing every normal in turn, each axis is given
+ * its place in that order, and the earliest of equally small overlaps wins.
+ *
+ * For internal use.
+ *
+ * @param range_a the minimum and maximum of the first shape's projection.
+ * @param range_b the minimum and maximum of the second shape's projection,
+ * relative to the first shape's position.
+ * @param axis the axis as an array of doubles (a point).
+ * @param place the place of the axis in the order.
+ * @param twin_place the place of the twin in the order, or `place` if there is
+ * no twin.
+ * @param best_place the place of the axis with the smallest overlap so far,
+ * which is updated along with the response.
+ * @param response the collision response to mutate.
+ * @return whether the ranges are separated, as a boolean.
+ */
+bool _satc_is_separating_twin_range (SATC_REAL *range_a, SATC_REAL *range_b, SATC_REAL *axis, size_t place, size_t twin_place, size_t *best_place, satc_response_t *response) {
+  if (range_a[0] > range_b[1] || range_b[0] > range_a[1]) {
+    return true;
+  }
+  if (response == NULL) return false;
+
+  SATC_REAL overlap = _satc_range_overlap(range_a, range_b, response);
+  SATC_REAL abs_overlap = SATC_FABS(overlap);
+  if (abs_overlap < response->overlap || (abs_overlap == response->overlap && place < *best_place)) {
+    response->overlap = abs_overlap;
+    satc_point_copy(response->overlap_n, axis);
+    if (overlap < 0) satc_point_reverse(response->overlap_n);
+    *best_place = place;
+  }
+  if (twin_place == place) return false;
+
+  SATC_REAL twin_range_a[2] = { -range_a[1], -range_a[0] };
+  SATC_REAL twin_range_b[2] = { -range_b[1], -range_b[0] };
+  overlap = _satc_range_overlap(twin_range_a, twin_range_b, response);
+  abs_overlap = SATC_FABS(overlap);
+  if (abs_overlap < response->overlap || (abs_overlap == response->overlap && twin_place < *best_place)) {
+    response->overlap = abs_overlap;
+    satc_point_copy(response->overlap_n, axis);
+    // The twin faces the other way.
+    if (overlap >= 0) satc_point_reverse(response->overlap_n);
+    *best_place = twin_place;
+  }
+  return false;
+}
+
+/**
+ * Figure out if an array of doubles (a point) representing a line, and another
+ * point represent either a left, middle, or right voronoi region.
+ *
+ * @param line an array of doubles (a point) representing a line.
+ * @param point an array of doubles (a point).
+ * @return an integer (-1, 0, or 1) representing which voronoi region was found.
+ */
+int satc_voronoi_region (SATC_REAL *line, SATC_REAL *point) {
+  SATC_REAL len_2 = satc_point_len2(line);
+  SATC_REAL dp = satc_point_dot(point, line);
+  // If the point is beyond the start of the line, it is in the left voronoi region.
+  if (dp < 0) return SATC_LEFT_VORONOI_REGION;
+  // If the point is beyond the end of the line, it is in the right voronoi region.
+  if (dp > len_2) return SATC_RIGHT_VORONOI_REGION;
+  return SATC_MIDDLE_VORONOI_REGION;
+}
+
+/**
+ * Returns true if an array of doubles (a point) is inside of a circle.
+ *
+ * @param p an array of doubles (a point).
+ * @param c a circle.
+ * @return true if point is inside of circle, false otherwise.
+ */
+bool satc_point_in_circle (SATC_REAL *point, satc_circle_t *circle) {
+  satc_vec2_t difference_v = satc_vec2_sub(satc_vec2_load(point), satc_vec2_load(circle->pos));
+  SATC_REAL radius_sq = circle->r * circle->r;
+  SATC_REAL distance_sq = satc_vec2_len2(difference_v);
+  return distance_sq <= radius_sq;
+}
+
+/**
+ * Returns true if an array of doubles (a point) is inside of a polygon.
+ *
+ * The point is tested against the polygon's cached bounding box, and then
+ * against the half-plane of every edge, using the polygon's calculated points
+ * and normals.
+ * Either winding order is accepted. Nothing is allocated.
+ *
+ * @param p an array of doubles (a point).
+ * @param polygon a polygon.
+ * @return true if point is inside of polygon, false otherwise.
+ */
+bool satc_point_in_polygon (SATC_REAL *point, satc_polygon_t *polygon) {
+  satc_polygon_update(polygon);
+  size_t len = polygon->num_calc_points;
+  if (len == 0) return false;
+
+  SATC_REAL *xs = polygon->calc_points.x;
+  SATC_REAL *ys = polygon->calc_points.y;
+  SATC_REAL *normals_x = polygon->normals.x;
+  SATC_REAL *normals_y = polygon->normals.y;
+  SATC_REAL px = satc_point_get_x(point) - satc_point_get_x(polygon->pos);
+  SATC_REAL py = satc_point_get_y(point) - satc_point_get_y(polygon->pos);
+  // The point must be within the polygon's bounds, which only matters for
+  // degenerate polygons. Points on the maximum `x` or `y` bound count as
+  // outside, as they always have.
+  satc_aabb_t *aabb = &polygon->aabb;
+  if (px < satc_point_get_x(aabb->min) || px >= satc_point_get_x(aabb->max)) return false;
+  if (py < satc_point_get_y(aabb->min) || py >= satc_point_get_y(aabb->max)) return false;
+
+  bool behind = false;
+  bool in_front = false;
+
+  size_t i = 0;
+  for (; i < len; i++) {
+    SATC_REAL d = (px - xs[i]) * normals_x[i] + (py - ys[i]) * normals_y[i];
+    if (d < 0) behind = true;
+    if (d > 0) in_front = true;
+  }
+
+  // The point must be on the same side of every edge.
+  return !(behind && in_front);
+}
+
+/**
+ * Returns true if a circle overlaps with another circle.
+ *
+ * @param a a circle.
+ * @param b another circle.
+ * @param response a response representing the collision.
+ * @return true if the circles overlap, false otherwise.
+ */
+bool satc_test_circle_circle (satc_circle_t *a, satc_circle_t *b, satc_response_t *response) {
+  satc_vec2_t difference_v = satc_vec2_sub(satc_vec2_load(b->pos), satc_vec2_load(a->pos));
+  SATC_REAL total_radius = a->r + b->r;
+  SATC_REAL total_radius_sq = total_radius * total_radius;
+  SATC_REAL distance_sq = satc_vec2_len2(difference_v);
+  if (response != NULL) satc_response_clear(response);
+  if (distance_sq > total_radius_sq) return false;
+  if (response != NULL) {
+    SATC_REAL distance = SATC_SQRT(distance_sq);
+    satc_vec2_t overlap_n = satc_vec2_normalize(difference_v);
+    response->a = a;
+    response->b = b;
+    response->overlap = total_radius - distance;
+    satc_vec2_store(response->overlap_n, overlap_n);
+    satc_vec2_store(response->overlap_v, satc_vec2_scale(overlap_n, response->overlap));
+    response->a_in_b = (a->r <= b->r) && (distance <= b->r - a->r);
+    response->b_in_a = (b->r <= a->r) && (distance <= a->r - b->r);
+  }
+
+  return true;
+}
+
+/**
+ * Work out where the center of a circle lies relative to each edge of a
+ * polygon, for `satc_test_polygon_circle`. With SIMD, a batch of edges is
+ * handled at once, and the distances along the edges' normals come from the
+ * polygon's cached normals rather than being normalized again.
+ *
+ * For internal use.
+ *
+ * @param polygon an up to date polygon.
+ * @param cx the `x` value of the circle's center, relative to the polygon.
+ * @param cy the `y` value of the circle's center, relative to the polygon.
+ * @param radius the radius of the circle.
+ * @param regions the array to fill with the voronoi region of the center for
+ * each edge, as in `satc_voronoi_region`.
+ * @param len2s the array to fill with the squared distance from each point to
+ * the center.
+ * @param dists the array to fill with the distance of the center in front of
+ * each edge, along its normal.
+ * @return whether the center is further than the radius in front of an edge
+ * whose middle region it lies in, which separates the shapes, as a boolean.
+ */
+bool _satc_polygon_circle_features (satc_polygon_t *polygon, SATC_REAL cx, SATC_REAL cy, SATC_REAL radius, SATC_REAL *regions, SATC_REAL *len2s, SATC_REAL *dists) {
+  SATC_REAL *xs = polygon->calc_points.x;
+  SATC_REAL *ys = polygon->calc_points.y;
+  SATC_REAL *edges_x = polygon->edges.x;
+  SATC_REAL *edges_y = polygon->edges.y;
+  SATC_REAL *normals_x = polygon->normals.x;
+  SATC_REAL *normals_y = polygon->normals.y;
+  size_t len = polygon->num_calc_points;
+  bool separated = false;
+  size_t i = 0;
+#ifdef SATC_SIMD
+  satc_simd_t center_x = satc_simd_set1(cx);
+  satc_simd_t center_y = satc_simd_set1(cy);
+  satc_simd_t zero = satc_simd_set1(0.0);
+  satc_simd_t left = satc_simd_set1(SATC_LEFT_VORONOI_REGION);
+  satc_simd_t right = satc_simd_set1(SATC_RIGHT_VORONOI_REGION);
+  // Only a positive distance separates, even for a negative radius.
+  satc_simd_t reach = satc_simd_set1(radius > 0.0 ? radius : 0.0);
+  satc_simd_t gap = zero;
+  for (; i + SATC_SIMD_WIDTH <= len; i += SATC_SIMD_WIDTH) {
+    satc_simd_t point_x = satc_simd_sub(center_x, satc_simd_load(xs + i));
+    satc_simd_t point_y = satc_simd_sub(center_y, satc_simd_load(ys + i));
+    satc_simd_t edge_x = satc_simd_load(edges_x + i);
+    satc_simd_t edge_y = satc_simd_load(edges_y + i);
+    satc_simd_t dp = satc_simd_add(satc_simd_mul(point_x, edge_x), satc_simd_mul(point_y, edge_y));
+    satc_simd_t edge_len2 = satc_simd_add(satc_simd_mul(edge_x, edge_x), satc_simd_mul(edge_y, edge_y));
+    satc_simd_t dist = satc_simd_add(satc_simd_mul(point_x, satc_simd_load(normals_x + i)), satc_simd_mul(point_y, satc_simd_load(normals_y + i)));
+    satc_simd_t in_left = satc_simd_gt(zero, dp);
+    satc_simd_t in_right = satc_simd_gt(dp, edge_len2);
+    satc_simd_store(regions + i, satc_simd_select(in_left, left, satc_simd_and(in_right, right)));
+    satc_simd_store(len2s + i, satc_simd_add(satc_simd_mul(point_x, point_x), satc_simd_mul(point_y, point_y)));
+    satc_simd_store(dists + i, dist);
+    gap = satc_simd_or(gap, satc_simd_andnot(satc_simd_or(in_left, in_right), satc_simd_gt(dist, reach)));
+  }
+  separated = satc_simd_any(gap);
+#endif
+  for (; i < len; i++) {
+    SATC_REAL point_x = cx - xs[i];
+    SATC_REAL point_y = cy - ys[i];
+    SATC_REAL dp = point_x * edges_x[i] + point_y * edges_y[i];
+    SATC_REAL edge_len2 = edges_x[i] * edges_x[i] + edges_y[i] * edges_y[i];
+    SATC_REAL dist = point_x * normals_x[i] + point_y * normals_y[i];
+    if (dp < 0) {
+      regions[i] = SATC_LEFT_VORONOI_REGION;
+    } else if (dp > edge_len2) {
+      regions[i] = SATC_RIGHT_VORONOI_REGION;
+    } else {
+      regions[i] = SATC_MIDDLE_VORONOI_REGION;
+      if (dist > 0.0 && dist > radius) separated = true;
+    }
+    len2s[i] = point_x * point_x + point_y * point_y;
+    dists[i] = dist;
+  }
+  return separated;
+}
+
+/**
+ * Like `satc_voronoi_region`, for the edge starting at some point, with all
+ * the values passed separately.
+ *
+ * For internal use.
+ *
+ * @param x the `x` value of the start of the edge.
+ * @param y the `y` value of the start of the edge.
+ * @param edge_x the `x` value of the edge.
+ * @param edge_y the `y` value of the edge.
+ * @param px the `x` value of the point.
+ * @param py the `y` value of the point.
+ * @return an integer (-1, 0, or 1) representing which voronoi region was found.
+ */
+int _satc_edge_region (SATC_REAL x, SATC_REAL y, SATC_REAL edge_x, SATC_REAL edge_y, SATC_REAL px, SATC_REAL py) {
+  SATC_REAL dp = (px - x) * edge_x + (py - y) * edge_y;
+  if (dp < 0) return SATC_LEFT_VORONOI_REGION;
+  if (dp > edge_x * edge_x + edge_y * edge_y) return SATC_RIGHT_VORONOI_REGION;
+  return SATC_MIDDLE_VORONOI_REGION;
+}
+
+/**
+ * Find an edge of a convex polygon whose outside a point lies on, for
+ * `satc_test_polygon_circle`. The polygon is split into a fan of triangles
+ * around its first point, and the triangle whose corner the point lies in
+ * is found by a binary search, so this takes logarithmic time.
+ *
+ * For internal use.
+ *
+ * @param polygon an up to date polygon whose normals turn counter-clockwise.
+ * @param cx the `x` value of the point, relative to the polygon.
+ * @param cy the `y` value of the point, relative to the polygon.
+ * @return the index of the edge, or the number of points if the point is
+ * inside the polygon or on its edges.
+ */
+size_t _satc_find_hull_facing_edge (satc_polygon_t *polygon, SATC_REAL cx, SATC_REAL cy) {
+  SATC_REAL *xs = polygon->calc_points.x;
+  SATC_REAL *ys = polygon->calc_points.y;
+  SATC_REAL *edges_x = polygon->edges.x;
+  SATC_REAL *edges_y = polygon->edges.y;
+  size_t len = polygon->num_calc_points;
+  SATC_REAL qx = cx - xs[0];
+  SATC_REAL qy = cy - ys[0];
+  // Outside the fan, the point is outside the first or the last edge.
+  if (edges_x[0] * qy - edges_y[0] * qx < 0.0) return 0;
+  if ((xs[len - 1] - xs[0]) * qy - (ys[len - 1] - ys[0]) * qx > 0.0) return len - 1;
+
+  size_t lo = 1;
+  size_t hi = len - 1;
+  while (hi - lo > 1) {
+    size_t mid = lo + (hi - lo) / 2;
+    if ((xs[mid] - xs[0]) * qy - (ys[mid] - ys[0]) * qx >= 0.0) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  if (edges_x[lo] * (cy - ys[lo]) - edges_y[lo] * (cx - xs[lo]) >= 0.0) return len;
+  return lo;
+}
+
+/**
+ * Find the edge or point of a convex polygon closest to a point
+ * outside it, for `satc_test_polygon_circle`. Starting from an edge whose
+ * outside the point lies on, this walks towards the edge whose middle
+ * voronoi region holds the point, or the point between two edges whose
+ * ends it lies beyond. That is usually the starting edge or a neighbor.
+ *
+ * For internal use.
+ *
+ * @param polygon an up to date polygon whose normals turn counter-clockwise.
+ * @param cx the `x` value of the point, relative to the polygon.
+ * @param cy the `y` value of the point, relative to the polygon.
+ * @param facing the edge to start from, from `_satc_find_hull_facing_edge`.
+ * @param corner set to whether the closest feature is a point rather than an
+ * edge.
+ * @return the index of the closest edge or point, or the number of points if
+ * rounding kept the walk from finding one.
+ */
+size_t _satc_find_hull_feature (satc_polygon_t *polygon, SATC_REAL cx, SATC_REAL cy, size_t facing, bool *corner) {
+  SATC_REAL *xs = polygon->calc_points.x;
+  SATC_REAL *ys = polygon->calc_points.y;
+  SATC_REAL *edges_x = polygon->edges.x;
+  SATC_REAL *edges_y = polygon->edges.y;
+  size_t len = polygon->num_calc_points;
+  size_t i = facing;
+  *corner = false;
+  // Each edge's voronoi region, as in `satc_voronoi_region`.
+  int region = _satc_edge_region(xs[i], ys[i], edges_x[i], edges_y[i], cx, cy);
+  size_t steps = 0;
+  for (; steps < len && region != SATC_MIDDLE_VORONOI_REGION; steps++) {
+    size_t j = region == SATC_LEFT_VORONOI_REGION ? (i + len - 1) % len : (i + 1) % len;
+    int next_region = _satc_edge_region(xs[j], ys[j], edges_x[j], edges_y[j], cx, cy);
+    if (next_region == -region) {
+      // Beyond the end of one edge and before the start of the next.
+      *corner = true;
+      return region == SATC_LEFT_VORONOI_REGION ? i : j;
+    }
+    i = j;
+    region = next_region;
+  }
+  return region == SATC_MIDDLE_VORONOI_REGION ? i : len;
+}
+
+/**
+ * Checks to see if one polygon and one circle are overlapping.
+ *
+ * When the circle's center is outside a convex polygon whose points go
+ * counter-clockwise, the closest edge or point is found by a binary search,
+ * in logarithmic time. Otherwise, where the circle lies relative to every
+ * edge is worked out up front, in SIMD batches when available, using the
+ * polygon's cached normals, and only the closest features are then resolved
+ * one edge at a time.
+ *
+ * @param polygon a polygon.
+ * @param circle a circle.
+ * @param response the response object to set with collision data.
+ */
+bool satc_test_polygon_circle (satc_polygon_t *polygon, satc_circle_t *circle, satc_response_t *response) {
+  satc_polygon_update(polygon);
+  if (response != NULL) satc_response_clear(response);
+  SATC_REAL cx = satc_point_get_x(circle->pos) - satc_point_get_x(polygon->pos);
+  SATC_REAL cy = satc_point_get_y(circle->pos) - satc_point_get_y(polygon->pos);
+  SATC_REAL radius = circle->r;
+  SATC_REAL radius2 = radius * radius;
+  SATC_REAL *xs = polygon->calc_points.x;
+  SATC_REAL *ys = polygon->calc_points.y;
+  SATC_REAL *normals_x = polygon->normals.x;
+  SATC_REAL *normals_y = polygon->normals.y;
+  size_t len = polygon->num_calc_points;
+  if (len == 0) return false;
+
+  // Shapes whose bounding boxes do not overlap can not collide.
+  satc_aabb_t polygon_aabb;
+  satc_aabb_t circle_aabb;
+  satc_polygon_get_bounds(polygon, &polygon_aabb);
+  satc_circle_get_bounds(circle, &circle_aabb);
+  if (!satc_aabb_overlaps(&polygon_aabb, &circle_aabb)) return false;
+
+  // Outside a convex polygon, only the closest edge or point matters, and it
+  // is found without visiting the others. From inside, every edge is needed
+  // to find the smallest overlap.
+  if (polygon->normal_turn > 0) {
+    size_t facing = _satc_find_hull_facing_edge(polygon, cx, cy);
+    if (facing == len && response == NULL) return true;
+    bool corner = false;
+    size_t feature = facing < len ? _satc_find_hull_feature(polygon, cx, cy, facing, &corner) : len;
+    if (feature < len) {
+      satc_point_alloca(overlap_n);
+      SATC_REAL dist = 0.0;
+      if (corner) {
+        satc_point_set_xy(overlap_n, cx - xs[feature], cy - ys[feature]);
+        dist = satc_point_len(overlap_n);
+        satc_point_normalize(overlap_n);
+      } else {
+        satc_point_set_xy(overlap_n, normals_x[feature], normals_y[feature]);
+        dist = (cx - xs[feature]) * normals_x[feature] + (cy - ys[feature]) * normals_y[feature];
+      }
+      if (dist > radius) return false;
+      if (response != NULL) {
+        // The polygon can only fit in the circle if its bounding box does.
+        SATC_REAL *min = polygon->aabb.min;
+        SATC_REAL *max = polygon->aabb.max;
+        if (max[0] - min[0] > 2.0 * radius || max[1] - min[1] > 2.0 * radius) {
+          response->a_in_b = false;
+        } else {
+          size_t i = 0;
+          for (; i < len && response->a_in_b; i++) {
+            SATC_REAL x = cx - xs[i];
+            SATC_REAL y = cy - ys[i];
+            if (x * x + y * y > radius2) response->a_in_b = false;
+          }
+        }
+        response->b_in_a = false;
+        response->a = polygon;
+        response->b = circle;
+        response->overlap = radius - dist;
+        satc_point_copy(response->overlap_n, overlap_n);
+        satc_point_copy(response->overlap_v, overlap_n);
+        satc_point_scale_x(response->overlap_v, response->overlap);
+      }
+      return true;
+    }
+  }
+
+  satc_real_array_alloca(regions, len);
+  satc_real_array_alloca(len2s, len);
+  satc_real_array_alloca(dists, len);
+  if (_satc_polygon_circle_features(polygon, cx, cy, radius, regions, len2s, dists)) {
+    return false;
+  }
+
+  satc_point_alloca(overlap_n);
+
+  size_t i = 0;
+  for (; i < len; i++) {
+    size_t next = (i == len - 1) ? 0 : i + 1;
+    size_t prev = (i == 0) ? len - 1 : i - 1;
+    SATC_REAL overlap = 0.0;
+
+    if (response != NULL && len2s[i] > radius2) {
+      response->a_in_b = false;
+    }
+
+    // The circle is closest to a point when it is past the end of one edge
+    // and before the start of the next.
+    size_t vertex = len;
+    if (regions[i] == SATC_LEFT_VORONOI_REGION && regions[prev] == SATC_RIGHT_VORONOI_REGION) {
+      vertex = i;
+    } else if (regions[i] == SATC_RIGHT_VORONOI_REGION && regions[next] == SATC_LEFT_VORONOI_REGION) {
+      vertex = next;
+    }
+
+    if (vertex < len) {
+      SATC_REAL dist = SATC_SQRT(len2s[vertex]);
+      if (dist > radius) return false;
+      if (response == NULL) continue;
+      response->b_in_a = false;
+      satc_point_set_xy(overlap_n, cx - xs[vertex], cy - ys[vertex]);
+      satc_point_normalize(overlap_n);
+      overlap = radius - dist;
+    } else if (regions[i] == SATC_MIDDLE_VORONOI_REGION) {
+      // Edges which separate the shapes were already found above.
+      if (response == NULL) continue;
+      SATC_REAL dist = dists[i];
+      satc_point_set_xy(overlap_n, normals_x[i], normals_y[i]);
+      overlap = radius - dist;
+      if (dist >= 0.0 || overlap < 2.0 * radius) {
+        response->b_in_a = false;
+      }
+    } else {
+      continue;
+    }
+
+    if (SATC_FABS(overlap) < SATC_FABS(response->overlap)) {
+      response->overlap = overlap;
+      satc_point_copy(response->overlap_n, overlap_n);
+    }
+  }
+
+  if (response != NULL) {
+    response->a = polygon;
+    response->b = circle;
+    satc_point_copy(response->overlap_v, response->overlap_n);
+    satc_point_scale_x(response->overlap_v, response->overlap);
+  }
+
+  return true;
+}
+
+/**
+ * Checks to see if one circle and one polygon are overlapping.
+ *
+ * This is ever so slightly more expensive than `satc_test_polygon_circle`,
+ * since the response data needs to be flipped after checking collision.
+ *
+ * @param circle a circle.
+ * @param polygon a polygon.
+ * @param response the response object to set with collision data.
+ */
+bool satc_test_circle_polygon (satc_circle_t *circle, satc_polygon_t *polygon, satc_response_t *response) {
+  bool result = satc_test_polygon_circle(polygon, circle, response);
+  if (result && response != NULL) {
+    void *a = response->a;
+    bool a_in_b = response->a_in_b;
+    satc_point_reverse(response->overlap_n);
+    satc_point_reverse(response->overlap_v);
+    response->a = response->b;
+    response->b = a;
+    response->a_in_b = response->b_in_a;
+    response->b_in_a = a_in_b;
+  }
+
   return result;
 }
 
 /**
- * Returns true if a circle overlaps with another circle.
+ * Get a polygon's own range along one of its normals, relative to its
+ * position, from its cached extents. Nothing is projected.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon.
+ * @param i the index of the normal.
+ * @param range the range to fill in.
+ */
+void _satc_polygon_own_range (satc_polygon_t *polygon, size_t i, SATC_REAL *range) {
+  SATC_REAL shift = satc_point_get_x(polygon->offset) * polygon->local_normals.x[i] + satc_point_get_y(polygon->offset) * polygon->local_normals.y[i];
+  range[0] = polygon->normal_extents.x[i] + shift;
+  range[1] = polygon->normal_extents.y[i] + shift;
+}
+
+/**
+ * Project two polygons onto one of the normals of the first, for
+ * `satc_test_polygon_polygon`. The first polygon's range comes from its
+ * cached extents, and the other polygon is searched if it is a hull, or
+ * projected point by point.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon whose normal is the axis.
+ * @param other the other polygon.
+ * @param offset the position of `other` relative to `polygon`.
+ * @param i the index of the normal.
+ * @param axis the array of two doubles (a point) to store the axis in.
+ * @param own_range the range to fill with the projection of `polygon`.
+ * @param other_range the range to fill with the projection of `other`,
+ * relative to `polygon`.
+ */
+void _satc_project_on_normal (satc_polygon_t *polygon, satc_polygon_t *other, satc_vec2_t offset, size_t i, SATC_REAL *axis, SATC_REAL *own_range, SATC_REAL *other_range) {
+  satc_point_set_xy(axis, polygon->normals.x[i], polygon->normals.y[i]);
+  _satc_polygon_own_range(polygon, i, own_range);
+  if (_satc_polygon_is_hull(other)) {
+    _satc_flatten_hull_on(other->num_calc_points, other->calc_points.x, other->calc_points.y, 1, &other->normals, other->normal_turn, axis, other_range);
+  } else {
+    satc_flatten_points_on(other->num_calc_points, &other->calc_points, axis, other_range);
+  }
+  SATC_REAL shift = offset.x * axis[0] + offset.y * axis[1];
+  other_range[0] += shift;
+  other_range[1] += shift;
+}
+
+/**
+ * Test a batch of up to `SATC_AXIS_BATCH` of one polygon's axes against
+ * another polygon, whose projections onto the whole batch are worked out at
+ * once by `_satc_flatten_points_on_axes`, or found one at a time by
+ * `_satc_flatten_hull_on` if it is a hull. When the batch is not separated
+ * and there is a response to fill in, the overlap along each axis is then
+ * worked out in order.
+ *
+ * For internal use.
+ *
+ * @param other the polygon to project.
+ * @param count the number of axes in the batch.
+ * @param axes_x the `x` values of the axes, with room for `SATC_AXIS_BATCH`.
+ * @param axes_y the `y` values of the axes, with room for `SATC_AXIS_BATCH`.
+ * @param shifts the position of `other` relative to the first polygon,
+ * projected onto each axis, with room for `SATC_AXIS_BATCH`.
+ * @param own_min the smallest value of the first polygon's range along each
+ * axis, with room for `SATC_AXIS_BATCH`.
+ * @param own_max the largest value of the first polygon's range along each
+ * axis, with room for `SATC_AXIS_BATCH`.
+ * @param places the place of each axis in the order of all the axes tested.
+ * @param twin_places the place of each axis's twin, or its own place if it
+ * has none.
+ * @param polygon_is_a whether the first polygon is the first polygon of the
+ * test.
+ * @param best_place the place of the axis with the smallest overlap so far,
+ * or of the axis which separates the polygons, if one does.
+ * @param response the collision response to mutate.
+ * @return whether one of the axes separates the polygons, as a boolean.
+ */
+bool _satc_is_separating_batch (satc_polygon_t *other, size_t count, SATC_REAL *axes_x, SATC_REAL *axes_y, SATC_REAL *shifts, SATC_REAL *own_min, SATC_REAL *own_max, size_t *places, size_t *twin_places, bool polygon_is_a, size_t *best_place, satc_response_t *response) {
+  SATC_REAL other_min[SATC_AXIS_BATCH];
+  SATC_REAL other_max[SATC_AXIS_BATCH];
+  SATC_REAL own_range[2];
+  SATC_REAL other_range[2];
+  SATC_REAL axis[2];
+  bool separated = false;
+  size_t k = 0;
+  if (_satc_polygon_is_hull(other)) {
+    for (; k < count && !separated; k++) {
+      satc_point_set_xy(axis, axes_x[k], axes_y[k]);
+      _satc_flatten_hull_on(other->num_calc_points, other->calc_points.x, other->calc_points.y, 1, &other->normals, other->normal_turn, axis, other_range);
+      other_min[k] = other_range[0] + shifts[k];
+      other_max[k] = other_range[1] + shifts[k];
+      separated = other_min[k] > own_max[k] || own_min[k] > other_max[k];
+    }
+  } else {
+    separated = _satc_flatten_points_on_axes(other->num_calc_points, &other->calc_points, count, axes_x, axes_y, shifts, own_min, own_max, other_min, other_max);
+  }
+  if (separated) {
+    k = 0;
+    while (k < count - 1 && other_min[k] <= own_max[k] && own_min[k] <= other_max[k]) k++;
+    *best_place = places[k];
+    return true;
+  }
+  if (response == NULL) return false;
+
+  for (k = 0; k < count; k++) {
+    satc_point_set_xy(axis, axes_x[k], axes_y[k]);
+    satc_point_set_xy(own_range, own_min[k], own_max[k]);
+    satc_point_set_xy(other_range, other_min[k], other_max[k]);
+    if (polygon_is_a) {
+      _satc_is_separating_twin_range(own_range, other_range, axis, places[k], twin_places[k], best_place, response);
+    } else {
+      _satc_is_separating_twin_range(other_range, own_range, axis, places[k], twin_places[k], best_place, response);
+    }
+  }
+  return false;
+}
+
+/**
+ * Test the axes along the normals of one polygon for
+ * `satc_test_polygon_polygon`. The polygon's own ranges come from its
+ * cached extents, so only the other polygon is projected. With
+ * `SATC_SIMD_AXES`, polygons with enough axes are projected onto in batches
+ * of `SATC_AXIS_BATCH`, by `_satc_is_separating_batch`.
+ *
+ * For internal use.
+ *
+ * @param polygon the polygon whose normals are the axes.
+ * @param other the other polygon.
+ * @param offset the position of `other` relative to `polygon`.
+ * @param polygon_is_a whether `polygon` is the first polygon of the test.
+ * @param first_place the place of the polygon's first normal in the order of
+ * all the axes tested.
+ * @param best_place the place of the axis with the smallest overlap so far,
+ * or of the axis which separates the polygons, if one does.
+ * @param response the collision response to mutate.
+ * @return whether one of the axes separates the polygons, as a boolean.
+ */
+bool _satc_is_separating_normals (satc_polygon_t *polygon, satc_polygon_t *other, satc_vec2_t offset, bool polygon_is_a, size_t first_place, size_t *best_place, satc_response_t *response) {
+  // Plain arrays rather than `alloca`, so that this can be inlined.
+  SATC_REAL own_range[2];
+  SATC_REAL other_range[2];
+  SATC_REAL axis[2];
+  size_t len = polygon->num_calc_points;
+  size_t i = 0;
+#ifdef SATC_SIMD_AXES
+  // Polygons with too few axes to fill half a batch, such as boxes, are
+  // quicker to test one axis at a time below, as are large hulls, which are
+  // searched rather than projected.
+  if (polygon->num_axes * 2 > SATC_AXIS_BATCH && !_satc_polygon_is_hull(other)) {
+    SATC_REAL axes_x[SATC_AXIS_BATCH];
+    SATC_REAL axes_y[SATC_AXIS_BATCH];
+    SATC_REAL shifts[SATC_AXIS_BATCH];
+    SATC_REAL own_min[SATC_AXIS_BATCH];
+    SATC_REAL own_max[SATC_AXIS_BATCH];
+    size_t places[SATC_AXIS_BATCH];
+    size_t twin_places[SATC_AXIS_BATCH];
+    while (i < len) {
+      // Gather the next batch of axes, leaving out the second of each pair of twins.
+      size_t count = 0;
+      for (; i < len && count < SATC_AXIS_BATCH; i++) {
+        if (polygon->normal_twins[i] < i) continue;
+        axes_x[count] = polygon->normals.x[i];
+        axes_y[count] = polygon->normals.y[i];
+        shifts[count] = offset.x * axes_x[count] + offset.y * axes_y[count];
+        _satc_polygon_own_range(polygon, i, own_range);
+        own_min[count] = own_range[0];
+        own_max[count] = own_range[1];
+        places[count] = first_place + i;
+        twin_places[count] = first_place + polygon->normal_twins[i];
+        count++;
+      }
+      if (count == 0) break;
+      if (_satc_is_separating_batch(other, count, axes_x, axes_y, shifts, own_min, own_max, places, twin_places, polygon_is_a, best_place, response)) {
+        return true;
+      }
+    }
+    return false;
+  }
+#endif
+
+  for (; i < len; i++) {
+    size_t twin = polygon->normal_twins[i];
+    if (twin < i) continue;
+    _satc_project_on_normal(polygon, other, offset, i, axis, own_range, other_range);
+    if (polygon_is_a) {
+      if (!_satc_is_separating_twin_range(own_range, other_range, axis, first_place + i, first_place + twin, best_place, response)) continue;
+    } else {
+      if (!_satc_is_separating_twin_range(other_range, own_range, axis, first_place + i, first_place + twin, best_place, response)) continue;
+    }
+    *best_place = first_place + i;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Checks to see if one polygon and another are overlapping, for
+ * `satc_test_polygon_polygon` and `satc_test_polygon_polygon_cached`.
+ *
+ * For internal use.
+ *
+ * @param a a polygon.
+ * @param b another polygon.
+ * @param cache the separating axis cache for the pair, or `NULL`.
+ * @param response the response object to set with collision data.
+ * @return whether the polygons overlap, as a boolean.
+ */
+bool _satc_test_polygon_polygon (satc_polygon_t *a, satc_polygon_t *b, satc_axis_cache_t *cache, satc_response_t *response) {
+  satc_polygon_update(a);
+  satc_polygon_update(b);
+  size_t a_len = a->num_calc_points;
+  size_t b_len = b->num_calc_points;
+
+  if (response != NULL) satc_response_clear(response);
+  if (a_len == 0 || b_len == 0) return false;
+
+  // Polygons whose bounding boxes do not overlap can not collide.
+  satc_aabb_t a_aabb;
+  satc_aabb_t b_aabb;
+  satc_polygon_get_bounds(a, &a_aabb);
+  satc_polygon_get_bounds(b, &b_aabb);
+  if (!satc_aabb_overlaps(&a_aabb, &b_aabb)) return false;
+
+  satc_vec2_t offset = satc_vec2_sub(satc_vec2_load(b->pos), satc_vec2_load(a->pos));
+
+  // Try the axis which separated the polygons last time first, which most
+  // often still does.
+  if (cache != NULL && cache->place < a_len + b_len) {
+    SATC_REAL own_range[2];
+    SATC_REAL other_range[2];
+    SATC_REAL axis[2];
+    bool on_a = cache->place < a_len;
+    satc_polygon_t *polygon = on_a ? a : b;
+    size_t i = on_a ? cache->place : cache->place - a_len;
+    // A twin shares its axis with the normal it is paired with.
+    if (polygon->normal_twins[i] < i) i = polygon->normal_twins[i];
+    _satc_project_on_normal(polygon, on_a ? b : a, on_a ? offset : satc_vec2_reverse(offset), i, axis, own_range, other_range);
+    if (other_range[0] > own_range[1] || own_range[0] > other_range[1]) return false;
+  }
+
+  size_t best_place = SIZE_MAX;
+  bool separated = _satc_is_separating_normals(a, b, offset, true, 0, &best_place, response);
+  // For B's axes, project from B's side. Both ranges end up relative to B's
+  // position instead of A's, which does not change how much they overlap.
+  if (!separated) {
+    separated = _satc_is_separating_normals(b, a, satc_vec2_reverse(offset), false, a_len, &best_place, response);
+  }
+  // Remember the axis which separated the polygons, or which gave their
+  // overlap, if it was worked out.
+  if (cache != NULL && best_place != SIZE_MAX) cache->place = best_place;
+  if (separated) return false;
+
+  if (response != NULL) {
+    response->a = a;
+    response->b = b;
+    satc_point_copy(response->overlap_v, response->overlap_n);
+    satc_point_scale_x(response->overlap_v, response->overlap);
+  }
+
+  return true;
+}
+
+/**
+ * Checks to see if one polygon and another are overlapping.
+ *
+ * Each axis shared by twin normals, such as the opposite sides of a box, is
+ * only tested once, and each polygon's range along its own normals is
+ * cached, so only the other polygon is projected onto an axis. Two boxes
+ * take four projections of four points each. With AVX, or SSE2 with floats,
+ * each point is projected onto several axes at once.
+ *
+ * @param a a polygon.
+ * @param b another polygon.
+ * @param response the response object to set with collision data.
+ */
+bool satc_test_polygon_polygon (satc_polygon_t *a, satc_polygon_t *b, satc_response_t *response) {
+  return _satc_test_polygon_polygon(a, b, NULL, response);
+}
+
+/**
+ * Checks to see if one polygon and another are overlapping, trying the axis
+ * remembered in a cache first.
+ *
+ * Polygons which were separated the last time they were tested are almost
+ * always separated by the same axis again, so most pairs which do not
+ * collide are done after a single projection. The cache is then updated with
+ * the axis which separated the polygons or, when there is a response, the
+ * axis of the overlap. The results are the same as from
+ * `satc_test_polygon_polygon`.
+ *
+ * @param a a polygon.
+ * @param b another polygon.
+ * @param cache the separating axis cache for the pair, which starts out as
+ * `SATC_AXIS_CACHE_INIT`. Always pass the polygons in the same order.
+ * @param response the response object to set with collision data.
+ * @return whether the polygons overlap, as a boolean.
+ */
+bool satc_test_polygon_polygon_cached (satc_polygon_t *a, satc_polygon_t *b, satc_axis_cache_t *cache, satc_response_t *response) {
+  return _satc_test_polygon_polygon(a, b, cache, response);
+}
+
+/**
+ * Checks to see if a polygon overlaps each of an array of circles and
+ * polygons, and lists the ones it does.
+ *
+ * Everything about the polygon is worked out once rather than for every
+ * shape: it is brought up to date, its bounding box is found, and its axes
+ * are gathered along with its own range along each. Each polygon in the
+ * array then only has to be projected onto the gathered axes, a batch at a
+ * time. The results are the same as from `satc_test_polygon_polygon` and
+ * `satc_test_polygon_circle`.
+ *
+ * @param polygon the polygon to test.
+ * @param count the number of shapes.
+ * @param shapes the circles and polygons to test it against. Shapes of any
+ * other type are never hit.
+ * @param hits the array to fill with the index of each shape the polygon
+ * overlaps, in order, with room for `count` indices.
+ * @param responses the array to fill with the response for each hit, with
+ * room for `count` responses, or `NULL`.
+ * @return the number of shapes the polygon overlaps.
+ */
+size_t satc_test_polygon_many (satc_polygon_t *polygon, size_t count, void **shapes, size_t *hits, satc_response_t *responses) {
+  satc_polygon_update(polygon);
+  size_t len = polygon->num_calc_points;
+  if (len == 0) return 0;
+  satc_aabb_t aabb;
+  satc_polygon_get_bounds(polygon, &aabb);
+
+  // Gather the axes, leaving out the second of each pair of twins. The
+  // arrays have room for a whole batch past the last axis.
+  size_t room = polygon->num_axes + SATC_AXIS_BATCH;
+  satc_real_array_alloca(axes_x, room);
+  satc_real_array_alloca(axes_y, room);
+  satc_real_array_alloca(own_min, room);
+  satc_real_array_alloca(own_max, room);
+  size_t *places = (size_t *) alloca(sizeof(size_t) * room);
+  size_t *twin_places = (size_t *) alloca(sizeof(size_t) * room);
+  SATC_REAL own_range[2];
+  size_t num_axes = 0;
+  size_t i = 0;
+  for (; i < len; i++) {
+    if (polygon->normal_twins[i] < i) continue;
+    axes_x[num_axes] = polygon->normals.x[i];
+    axes_y[num_axes] = polygon->normals.y[i];
+    _satc_polygon_own_range(polygon, i, own_range);
+    own_min[num_axes] = own_range[0];
+    own_max[num_axes] = own_range[1];
+    places[num_axes] = i;
+    twin_places[num_axes] = polygon->normal_twins[i];
+    num_axes++;
+  }
+
+  SATC_REAL shifts[SATC_AXIS_BATCH];
+  size_t num_hits = 0;
+  size_t c = 0;
+  for (; c < count; c++) {
+    satc_response_t *response = responses != NULL ? &responses[num_hits] : NULL;
+    int type = *(int *) shapes[c];
+    bool hit = false;
+    if (type == satc_type_circle) {
+      hit = satc_test_polygon_circle(polygon, shapes[c], response);
+    } else if (type == satc_type_polygon) {
+      satc_polygon_t *other = shapes[c];
+      satc_polygon_update(other);
+      if (response != NULL) satc_response_clear(response);
+      if (other->num_calc_points == 0) continue;
+      satc_aabb_t other_aabb;
+      satc_polygon_get_bounds(other, &other_aabb);
+      if (!satc_aabb_overlaps(&aabb, &other_aabb)) continue;
+
+      satc_vec2_t offset = satc_vec2_sub(satc_vec2_load(other->pos), satc_vec2_load(polygon->pos));
+      size_t best_place = SIZE_MAX;
+      bool separated = false;
+      size_t first = 0;
+      for (; first < num_axes && !separated; first += SATC_AXIS_BATCH) {
+        size_t batch = num_axes - first < SATC_AXIS_BATCH ? num_axes - first : SATC_AXIS_BATCH;
+        size_t k = 0;
+        for (; k < batch; k++) {
+          shifts[k] = offset.x * axes_x[first + k] + offset.y * axes_y[first + k];
+        }
+        separated = _satc_is_separating_batch(other, batch, axes_x + first, axes_y + first, shifts, own_min + first, own_max + first, places + first, twin_places + first, true, &best_place, response);
+      }
+      // For the other polygon's axes, project from its side.
+      if (separated || _satc_is_separating_normals(other, polygon, satc_vec2_reverse(offset), false, len, &best_place, response)) {
+        continue;
+      }
+      if (response != NULL) {
+        response->a = polygon;
+        response->b = other;
+        satc_point_copy(response->overlap_v, response->overlap_n);
+        satc_point_scale_x(response->overlap_v, response->overlap);
+      }
+      hit = true;
+    }
+    if (hit) hits[num_hits++] = c;
+  }
+  return num_hits;
+}
+
+/**
+ * Checks to see if a circle overlaps each of an array of circles and
+ * polygons, and lists the ones it does.
+ *
+ * The circle's bounding box is found once, and shapes whose bounding boxes
+ * do not overlap it are passed over without a call. The results are the
+ * same as from `satc_test_circle_circle` and `satc_test_circle_polygon`.
+ *
+ * @param circle the circle to test.
+ * @param count the number of shapes.
+ * @param shapes the circles and polygons to test it against. Shapes of any
+ * other type are never hit.
+ * @param hits the array to fill with the index of each shape the circle
+ * overlaps, in order, with room for `count` indices.
+ * @param responses the array to fill with the response for each hit, with
+ * room for `count` responses, or `NULL`.
+ * @return the number of shapes the circle overlaps.
+ */
+size_t satc_test_circle_many (satc_circle_t *circle, size_t count, void **shapes, size_t *hits, satc_response_t *responses) {
+  satc_aabb_t aabb;
+  satc_circle_get_bounds(circle, &aabb);
+  satc_vec2_t position = satc_vec2_load(circle->pos);
+
+  size_t num_hits = 0;
+  size_t c = 0;
+  for (; c < count; c++) {
+    satc_response_t *response = responses != NULL ? &responses[num_hits] : NULL;
+    int type = *(int *) shapes[c];
+    bool hit = false;
+    if (type == satc_type_circle) {
+      satc_circle_t *other = shapes[c];
+      satc_vec2_t difference_v = satc_vec2_sub(satc_vec2_load(other->pos), position);
+      SATC_REAL total_radius = circle->r + other->r;
+      // Most circles are too far away, which needs no call to tell. This is
+      // worked out as `satc_test_circle_circle` does, so the two agree.
+      if (satc_vec2_len2(difference_v) > total_radius * total_radius) continue;
+      hit = satc_test_circle_circle(circle, other, response);
+    } else if (type == satc_type_polygon) {
+      satc_polygon_t *other = shapes[c];
+      satc_aabb_t other_aabb;
+      satc_polygon_update(other);
+      satc_polygon_get_bounds(other, &other_aabb);
+      if (other->num_calc_points == 0 || !satc_aabb_overlaps(&aabb, &other_aabb)) continue;
+      hit = satc_test_circle_polygon(circle, other, response);
+    }
+    if (hit) hits[num_hits++] = c;
+  }
+  return num_hits;
+}
+
+/**
+ * Stores the result of testing one pair into `satc_pair_results_t`.
+ *
+ * For internal use.
+ *
+ * @param results the results.
+ * @param k the index of the pair.
+ * @param hit whether the pair overlaps.
+ * @param response the pair's response, or `NULL` if there is none.
+ */
+void _satc_pair_results_store (satc_pair_results_t *results, size_t k, bool hit, satc_response_t *response) {
+  results->hit[k] = hit;
+  if (response == NULL) return;
+  if (results->overlap != NULL) results->overlap[k] = hit ? response->overlap : 0.0;
+  if (results->overlap_n.x != NULL) results->overlap_n.x[k] = hit ? satc_point_get_x(response->overlap_n) : 0.0;
+  if (results->overlap_n.y != NULL) results->overlap_n.y[k] = hit ? satc_point_get_y(response->overlap_n) : 0.0;
+  if (results->a_in_b != NULL) results->a_in_b[k] = hit && response->a_in_b;
+  if (results->b_in_a != NULL) results->b_in_a[k] = hit && response->b_in_a;
+}
+
+/**
+ * Tests a group of pairs of circles for `satc_test_pairs`.
+ *
+ * For internal use.
+ *
+ * @param shapes the shapes.
+ * @param pairs the pairs.
+ * @param group the indices of the pairs in the group.
+ * @param count the number of pairs in the group.
+ * @param results the results.
+ * @param response a response to work in, or `NULL` to skip the responses.
+ * @return the number of pairs which overlap.
+ */
+size_t _satc_test_circle_pairs (void **shapes, satc_pair_t *pairs, size_t *group, size_t count, satc_pair_results_t *results, satc_response_t *response) {
+  size_t num_hits = 0;
+  size_t i = 0;
+  for (; i < count; i++) {
+    size_t k = group[i];
+    satc_circle_t *a = shapes[pairs[k].a];
+    satc_circle_t *b = shapes[pairs[k].b];
+    // The same arithmetic as `satc_test_circle_circle`, so that the two
+    // agree on circles which only just touch.
+    satc_vec2_t difference_v = satc_vec2_sub(satc_vec2_load(b->pos), satc_vec2_load(a->pos));
+    SATC_REAL total_radius = a->r + b->r;
+    bool hit = satc_vec2_len2(difference_v) <= total_radius * total_radius;
+    // Only circles which overlap need the rest of the test.
+    if (hit && response != NULL) hit = satc_test_circle_circle(a, b, response);
+    _satc_pair_results_store(results, k, hit, response);
+    num_hits += hit;
+  }
+  return num_hits;
+}
+
+/**
+ * Checks to see if the shapes of each of an array of pairs overlap, such as
+ * the pairs found by a broadphase, and stores the results as a structure of
+ * arrays.
+ *
+ * The pairs are taken a batch of `SATC_PAIR_BATCH` at a time, and sorted by
+ * the types of their shapes, so that all of the pairs of circles are tested
+ * together, then all of the polygons and circles, and so on. Each test then
+ * runs over the same kind of shapes many times in a row. The results are
+ * the same as from `satc_test_circle_circle`, `satc_test_polygon_circle`,
+ * `satc_test_circle_polygon`, and `satc_test_polygon_polygon`, and are
+ * stored in the order of the pairs. Pairs with shapes of any other type
+ * never overlap.
+ *
+ * @param shapes the circles and polygons the pairs index into.
+ * @param count the number of pairs.
+ * @param pairs the pairs to test.
+ * @param results the results, with room for `count` pairs.
+ * @return the number of pairs which overlap.
+ */
+size_t satc_test_pairs (void **shapes, size_t count, satc_pair_t *pairs, satc_pair_results_t *results) {
+  bool responses = results->overlap != NULL || results->overlap_n.x != NULL || results->overlap_n.y != NULL || results->a_in_b != NULL || results->b_in_a != NULL;
+  satc_response_t response_value = SATC_RESPONSE_INIT;
+  satc_response_t *response = responses ? &response_value : NULL;
+  // The pairs of each type, as circle and circle, polygon and circle,
+  // circle and polygon, and polygon and polygon.
+  size_t groups[4][SATC_PAIR_BATCH];
+  size_t sizes[4];
+  size_t num_hits = 0;
+  size_t first = 0;
+  for (; first < count; first += SATC_PAIR_BATCH) {
+    size_t last = count - first < SATC_PAIR_BATCH ? count : first + SATC_PAIR_BATCH;
+    sizes[0] = sizes[1] = sizes[2] = sizes[3] = 0;
+    size_t k = first;
+    for (; k < last; k++) {
+      int a_type = *(int *) shapes[pairs[k].a];
+      int b_type = *(int *) shapes[pairs[k].b];
+      bool a_ok = a_type == satc_type_circle || a_type == satc_type_polygon;
+      bool b_ok = b_type == satc_type_circle || b_type == satc_type_polygon;
+      if (!a_ok || !b_ok) {
+        _satc_pair_results_store(results, k, false, response);
+        continue;
+      }
+      int group = (a_type == satc_type_polygon) + 2 * (b_type == satc_type_polygon);
+      groups[group][sizes[group]++] = k;
+    }
+
+    num_hits += _satc_test_circle_pairs(shapes, pairs, groups[0], sizes[0], results, response);
+    size_t i = 0;
+    for (; i < sizes[1]; i++) {
+      k = groups[1][i];
+      bool hit = satc_test_polygon_circle(shapes[pairs[k].a], shapes[pairs[k].b], response);
+      _satc_pair_results_store(results, k, hit, response);
+      num_hits += hit;
+    }
+    for (i = 0; i < sizes[2]; i++) {
+      k = groups[2][i];
+      bool hit = satc_test_circle_polygon(shapes[pairs[k].a], shapes[pairs[k].b], response);
+      _satc_pair_results_store(results, k, hit, response);
+      num_hits += hit;
+    }
+    for (i = 0; i < sizes[3]; i++) {
+      k = groups[3][i];
+      bool hit = satc_test_polygon_polygon(shapes[pairs[k].a], shapes[pairs[k].b], response);
+      _satc_pair_results_store(results, k, hit, response);
+      num_hits += hit;
+    }
+  }
+  return num_hits;
+}
+
+/**
+ * Lists the circles of a set, between two indices, which overlap a circle.
+ *
+ * For internal use.
+ *
+ * @param x the `x` position of the circle.
+ * @param y the `y` position of the circle.
+ * @param r the radius of the circle.
+ * @param set the set of circles.
+ * @param first the index of the first circle of the set to test.
+ * @param last the index after the last circle of the set to test.
+ * @param hits the array to fill with the indices of the circles which
+ * overlap, with room for `last - first` indices.
+ * @return the number of circles which overlap.
+ */
+size_t _satc_circle_set_collect (SATC_REAL x, SATC_REAL y, SATC_REAL r, satc_circle_set_t *set, size_t first, size_t last, size_t *hits) {
+  size_t num_hits = 0;
+  size_t j = first;
+#ifdef SATC_SIMD
+  satc_simd_t vx = satc_simd_set1(x);
+  satc_simd_t vy = satc_simd_set1(y);
+  satc_simd_t vr = satc_simd_set1(r);
+  for (; j + SATC_SIMD_WIDTH <= last; j += SATC_SIMD_WIDTH) {
+    satc_simd_t dx = satc_simd_sub(satc_simd_load(set->x + j), vx);
+    satc_simd_t dy = satc_simd_sub(satc_simd_load(set->y + j), vy);
+    satc_simd_t total_radius = satc_simd_add(vr, satc_simd_load(set->r + j));
+    satc_simd_t distance_sq = satc_simd_add(satc_simd_mul(dx, dx), satc_simd_mul(dy, dy));
+    int lanes = ~satc_simd_bits(satc_simd_gt(distance_sq, satc_simd_mul(total_radius, total_radius))) & ((1 << SATC_SIMD_WIDTH) - 1);
+    // Most circles are apart, so only lanes which overlap are looked at.
+    if (lanes == 0) continue;
+    size_t lane = 0;
+    for (; lane < SATC_SIMD_WIDTH; lane++) {
+      if (lanes & (1 << lane)) hits[num_hits++] = j + lane;
+    }
+  }
+#endif
+  // Worked out as `satc_test_circle_circle` does, so that the two agree on
+  // circles which only just touch.
+  for (; j < last; j++) {
+    satc_vec2_t difference_v = satc_vec2(set->x[j] - x, set->y[j] - y);
+    SATC_REAL total_radius = r + set->r[j];
+    if (satc_vec2_len2(difference_v) > total_radius * total_radius) continue;
+    hits[num_hits++] = j;
+  }
+  return num_hits;
+}
+
+/**
+ * Stores the overlap vector of two circles which overlap, as worked out by
+ * `satc_test_circle_circle`.
+ *
+ * For internal use.
+ *
+ * @param ax the `x` position of the first circle.
+ * @param ay the `y` position of the first circle.
+ * @param ar the radius of the first circle.
+ * @param bx the `x` position of the second circle.
+ * @param by the `y` position of the second circle.
+ * @param br the radius of the second circle.
+ * @param overlap_v the overlap vectors.
+ * @param k the index to store the overlap vector at.
+ */
+void _satc_circle_set_store_overlap (SATC_REAL ax, SATC_REAL ay, SATC_REAL ar, SATC_REAL bx, SATC_REAL by, SATC_REAL br, satc_points_t *overlap_v, size_t k) {
+  satc_vec2_t difference_v = satc_vec2(bx - ax, by - ay);
+  SATC_REAL distance = SATC_SQRT(satc_vec2_len2(difference_v));
+  satc_vec2_t v = satc_vec2_scale(satc_vec2_normalize(difference_v), ar + br - distance);
+  overlap_v->x[k] = v.x;
+  overlap_v->y[k] = v.y;
+}
+
+/**
+ * Checks to see which circles of a set overlap a circle.
+ *
+ * The set is tested `SATC_SIMD_WIDTH` circles at a time. The results are
+ * the same as from `satc_test_circle_circle` with the circle as `a`.
+ *
+ * @param circle the circle to test.
+ * @param set the set of circles to test it against.
+ * @param hits the array to fill with the index of each circle of the set
+ * which overlaps the circle, in order, with room for `set->count` indices.
+ * @param overlap_v arrays to fill with the overlap vector of each hit, as
+ * `overlap_v` in `satc_response_t`, with room for `set->count` vectors, or
+ * `NULL`.
+ * @return the number of circles which overlap the circle.
+ */
+size_t satc_test_circle_circle_set (satc_circle_t *circle, satc_circle_set_t *set, size_t *hits, satc_points_t *overlap_v) {
+  SATC_REAL x = satc_point_get_x(circle->pos);
+  SATC_REAL y = satc_point_get_y(circle->pos);
+  size_t num_hits = _satc_circle_set_collect(x, y, circle->r, set, 0, set->count, hits);
+  if (overlap_v == NULL) return num_hits;
+  size_t k = 0;
+  for (; k < num_hits; k++) {
+    size_t j = hits[k];
+    _satc_circle_set_store_overlap(x, y, circle->r, set->x[j], set->y[j], set->r[j], overlap_v, k);
+  }
+  return num_hits;
+}
+
+/**
+ * Lists the circles of a set which are entirely inside a circle.
+ *
+ * The set is tested `SATC_SIMD_WIDTH` circles at a time. A circle is listed
+ * exactly when `satc_test_circle_circle`, with the circle as `a`, would set
+ * `b_in_a`.
+ *
+ * @param circle the circle which may contain the circles of the set.
+ * @param set the set of circles.
+ * @param hits the array to fill with the index of each circle of the set
+ * which is inside the circle, in order, with room for `set->count` indices.
+ * @return the number of circles which are inside the circle.
+ */
+size_t satc_circle_set_find_inside (satc_circle_t *circle, satc_circle_set_t *set, size_t *hits) {
+  SATC_REAL x = satc_point_get_x(circle->pos);
+  SATC_REAL y = satc_point_get_y(circle->pos);
+  SATC_REAL r = circle->r;
+  size_t num_hits = 0;
+  size_t j = 0;
+#ifdef SATC_SIMD
+  satc_simd_t vx = satc_simd_set1(x);
+  satc_simd_t vy = satc_simd_set1(y);
+  satc_simd_t vr = satc_simd_set1(r);
+  for (; j + SATC_SIMD_WIDTH <= set->count; j += SATC_SIMD_WIDTH) {
+    satc_simd_t dx = satc_simd_sub(satc_simd_load(set->x + j), vx);
+    satc_simd_t dy = satc_simd_sub(satc_simd_load(set->y + j), vy);
+    satc_simd_t rs = satc_simd_load(set->r + j);
+    satc_simd_t distance = satc_simd_sqrt(satc_simd_add(satc_simd_mul(dx, dx), satc_simd_mul(dy, dy)));
+    satc_simd_t outside = satc_simd_or(satc_simd_gt(rs, vr), satc_simd_gt(distance, satc_simd_sub(vr, rs)));
+    int lanes = ~satc_simd_bits(outside) & ((1 << SATC_SIMD_WIDTH) - 1);
+    if (lanes == 0) continue;
+    size_t lane = 0;
+    for (; lane < SATC_SIMD_WIDTH; lane++) {
+      if (lanes & (1 << lane)) hits[num_hits++] = j + lane;
+    }
+  }
+#endif
+  for (; j < set->count; j++) {
+    satc_vec2_t difference_v = satc_vec2(set->x[j] - x, set->y[j] - y);
+    SATC_REAL distance = SATC_SQRT(satc_vec2_len2(difference_v));
+    if (set->r[j] <= r && distance <= r - set->r[j]) hits[num_hits++] = j;
+  }
+  return num_hits;
+}
+
+/**
+ * Checks to see which circles of one set overlap which circles of another,
+ * or of the same set.
  *
- * @param a a circle.
- * @param b another circle.
- * @param response a response representing the collision.
- * @return true if the circles overlap, false otherwise.
+ * The sets are worked through in blocks of `SATC_CIRCLE_SET_BLOCK` circles,
+ * so that each block of `b` is tested against a whole block of `a` while it
+ * is in cache, and each circle of `a` is tested against `SATC_SIMD_WIDTH`
+ * circles of `b` at a time. The results are the same as from
+ * `satc_test_circle_circle`. If `a` and `b` are the same set, each pair of
+ * its circles is only listed once, with the lower index first, and no circle
+ * is tested against itself.
+ *
+ * @param a a set of circles.
+ * @param b another set of circles, or `a` again.
+ * @param max_pairs the number of pairs `pairs` has room for.
+ * @param pairs the array to fill with the indices of the circles of each
+ * pair which overlaps, block by block. Pairs past `max_pairs` are counted,
+ * but not stored.
+ * @param overlap_v arrays to fill with the overlap vector of each stored
+ * pair, as `overlap_v` in `satc_response_t`, with room for `max_pairs`
+ * vectors, or `NULL`.
+ * @return the number of pairs which overlap, which may be more than
+ * `max_pairs`.
  */
-bool satc_test_circle_circle (satc_circle_t *a, satc_circle_t *b, satc_response_t *response) {
-  satc_point_alloca(difference_v);
-  satc_point_copy(difference_v, b->pos);
-  satc_point_sub(difference_v, a->pos);
-  double total_radius = a->r + b->r;
-  double total_radius_sq = total_radius * total_radius;
-  double distance_sq = satc_point_len2(difference_v);
-  if (response != NULL) satc_response_clear(response);
-  if (distance_sq > total_radius_sq) return false;
-  if (response != NULL) {
-    double distance = sqrt(distance_sq);
-    response->a = a;
-    response->b = b;
-    response->overlap = total_radius - distance;
-    satc_point_normalize(difference_v);
-    satc_point_copy(response->overlap_n, difference_v);
-    satc_point_scale_x(difference_v, response->overlap);
-    satc_point_copy(response->overlap_v, difference_v);
-    response->a_in_b = (a->r <= b->r) && (distance <= b->r - a->r);
-    response->b_in_a = (b->r <= a->r) && (distance <= a->r - b->r);
+size_t satc_test_circle_sets (satc_circle_set_t *a, satc_circle_set_t *b, size_t max_pairs, satc_pair_t *pairs, satc_points_t *overlap_v) {
+  size_t block_hits[SATC_CIRCLE_SET_BLOCK];
+  size_t num_pairs = 0;
+  size_t a_first = 0;
+  for (; a_first < a->count; a_first += SATC_CIRCLE_SET_BLOCK) {
+    size_t a_last = a->count - a_first < SATC_CIRCLE_SET_BLOCK ? a->count : a_first + SATC_CIRCLE_SET_BLOCK;
+    // Within one set, the blocks before this one have been done already.
+    size_t b_first = a == b ? a_first : 0;
+    for (; b_first < b->count; b_first += SATC_CIRCLE_SET_BLOCK) {
+      size_t b_last = b->count - b_first < SATC_CIRCLE_SET_BLOCK ? b->count : b_first + SATC_CIRCLE_SET_BLOCK;
+      size_t i = a_first;
+      for (; i < a_last; i++) {
+        size_t from = a == b && b_first <= i ? i + 1 : b_first;
+        if (from >= b_last) continue;
+        size_t num_hits = _satc_circle_set_collect(a->x[i], a->y[i], a->r[i], b, from, b_last, block_hits);
+        size_t k = 0;
+        for (; k < num_hits; k++, num_pairs++) {
+          if (num_pairs >= max_pairs) continue;
+          size_t j = block_hits[k];
+          pairs[num_pairs].a = i;
+          pairs[num_pairs].b = j;
+          if (overlap_v != NULL) _satc_circle_set_store_overlap(a->x[i], a->y[i], a->r[i], b->x[j], b->y[j], b->r[j], overlap_v, num_pairs);
+        }
+      }
+    }
   }
+  return num_pairs;
+}
 
-  return true;
+/**
+ * Test one axis for `satc_test_polygon_polygon_local`, along one of the
+ * local normals of `a`. The range of `a` comes from its cached extents, and
+ * the axis is rotated into the local space of `b`, so neither polygon's
+ * points need to be transformed.
+ *
+ * For internal use.
+ *
+ * @param a a polygon, whose local space the axis is in.
+ * @param b another polygon.
+ * @param offset the position of `b` relative to `a`.
+ * @param i the index of the local normal of `a`.
+ * @param range_a the range to fill with the projection of `a`.
+ * @param range_b the range to fill with the projection of `b`, relative to `a`.
+ * @return the axis in world space.
+ */
+satc_vec2_t _satc_project_local (satc_polygon_t *a, satc_polygon_t *b, satc_vec2_t offset, size_t i, SATC_REAL *range_a, SATC_REAL *range_b) {
+  satc_point_alloca(local_axis);
+  satc_vec2_t axis = satc_vec2(a->local_normals.x[i], a->local_normals.y[i]);
+  satc_vec2_t world_axis = satc_vec2_rotate_cs(axis, satc_point_get_x(a->rotation), satc_point_get_y(a->rotation));
+  satc_vec2_t b_axis = satc_vec2_rotate_cs(world_axis, satc_point_get_x(b->rotation), -satc_point_get_y(b->rotation));
+  _satc_polygon_own_range(a, i, range_a);
+
+  satc_vec2_store(local_axis, b_axis);
+  if (_satc_polygon_is_hull(b)) {
+    _satc_flatten_hull_on(b->num_points, b->points.x, b->points.y, b->points_stride, &b->local_normals, b->normal_turn, local_axis, range_b);
+  } else {
+    _satc_flatten_strided_points_on(b->num_points, b->points.x, b->points.y, b->points_stride, local_axis, range_b);
+  }
+  SATC_REAL b_shift = satc_vec2_dot(satc_vec2_load(b->offset), b_axis) + satc_vec2_dot(offset, world_axis);
+  range_b[0] += b_shift;
+  range_b[1] += b_shift;
+  return world_axis;
 }
 
 /**
- * Checks to see if one polygon and one circle are overlapping.
+ * Checks to see if one polygon and another are overlapping, working from
+ * their untransformed points plus their positions, offsets, and angles.
  *
- * @param polygon a polygon.
- * @param circle a circle.
+ * Unlike `satc_test_polygon_polygon`, the calculated points, edges, and
+ * normals of the polygons are never recalculated. Instead, each axis is
+ * rotated into the other polygon's local space as it is tested, so moving or
+ * rotating a polygon costs nothing until it is tested. The results match
+ * `satc_test_polygon_polygon`, up to rounding.
+ *
+ * @param a a polygon.
+ * @param b another polygon.
  * @param response the response object to set with collision data.
  */
-bool satc_test_polygon_circle (satc_polygon_t *polygon, satc_circle_t *circle, satc_response_t *response) {
-  satc_point_alloca(circle_pos);
-  satc_point_copy(circle_pos, circle->pos);
-  satc_point_sub(circle_pos, polygon->pos);
-  if (response != NULL) satc_response_clear(response);
-  double radius = circle->r;
-  double radius2 = radius * radius;
-  double **points = polygon->calc_points;
-  size_t len = polygon->num_calc_points;
-  if (len == 0) return false;
-  satc_point_alloca(edge);
-  satc_point_alloca(point);
+bool satc_test_polygon_polygon_local (satc_polygon_t *a, satc_polygon_t *b, satc_response_t *response) {
+  _satc_polygon_update_local(a);
+  _satc_polygon_update_local(b);
 
-  size_t i = 0;
-  for (; i < len; i++) {
-    size_t next = (i == len - 1) ? 0 : i + 1;
-    size_t prev = (i == 0) ? len - 1 : i - 1;
-    double overlap = 0.0;
-    double *overlap_n = NULL;
+  if (response != NULL) satc_response_clear(response);
+  if (a->num_points == 0 || b->num_points == 0) return false;
+
+  // The cached bounding boxes can only be used if they are already current.
+  if (!(a->dirty & SATC_POLYGON_DIRTY_CALC_POINTS) && !(b->dirty & SATC_POLYGON_DIRTY_CALC_POINTS)) {
+    satc_aabb_t a_aabb;
+    satc_aabb_t b_aabb;
+    satc_polygon_get_bounds(a, &a_aabb);
+    satc_polygon_get_bounds(b, &b_aabb);
+    if (!satc_aabb_overlaps(&a_aabb, &b_aabb)) return false;
+  }
 
-    satc_point_copy(edge, polygon->edges[i]);
-    satc_point_copy(point, circle_pos);
-    satc_point_sub(point, points[i]);
+  satc_vec2_t offset = satc_vec2_sub(satc_vec2_load(b->pos), satc_vec2_load(a->pos));
+  satc_real_array_alloca(range_a, 2);
+  satc_real_array_alloca(range_b, 2);
+  satc_point_alloca(axis);
 
-    if (response != NULL && satc_point_len2(point) > radius2) {
-      response->a_in_b = false;
-    }
+  size_t best_place = SIZE_MAX;
 
-    int region = satc_voronoi_region(edge, point);
-    if (region == SATC_LEFT_VORONOI_REGION) {
-      satc_point_copy(edge, polygon->edges[prev]);
-      satc_point_alloca(point2);
-      satc_point_copy(point2, circle_pos);
-      satc_point_sub(point2, points[prev]);
-      region = satc_voronoi_region(edge, point2);
-      if (region == SATC_RIGHT_VORONOI_REGION) {
-        double dist = satc_point_len(point);
-        if (dist > radius) {
-          return false;
-        } else if (response != NULL) {
-          response->b_in_a = false;
-          satc_point_normalize(point);
-          overlap_n = point;
-          overlap = radius - dist;
-        }
-      }
-    } else if (region == SATC_RIGHT_VORONOI_REGION) {
-      satc_point_copy(edge, polygon->edges[next]);
-      satc_point_copy(point, circle_pos);
-      satc_point_sub(point, points[next]);
-      region = satc_voronoi_region(edge, point);
-      if (region == SATC_LEFT_VORONOI_REGION) {
-        double dist = satc_point_len(point);
-        if (dist > radius) {
-          return false;
-        } else if (response != NULL) {
-          response->b_in_a = false;
-          satc_point_normalize(point);
-          overlap_n = point;
-          overlap = radius - dist;
-        }
-      }
-    } else {
-      satc_point_alloca(normal);
-      satc_point_perp(edge);
-      satc_point_normalize(edge);
-      satc_point_copy(normal, edge);
-      double dist = satc_point_dot(point, normal);
-      double dist_abs = fabs(dist);
-      if (dist > 0.0 && dist_abs > radius) {
-        return false;
-      } else {
-        overlap_n = normal;
-        overlap = radius - dist;
-        if (response != NULL && (dist >= 0.0 || overlap < 2.0 * radius)) {
-          response->b_in_a = false;
-        }
-      }
+  size_t i = 0;
+  for (; i < a->num_points; i++) {
+    size_t twin = a->normal_twins[i];
+    if (twin < i) continue;
+    satc_vec2_store(axis, _satc_project_local(a, b, offset, i, range_a, range_b));
+    if (_satc_is_separating_twin_range(range_a, range_b, axis, i, twin, &best_place, response)) {
+      return false;
     }
+  }
 
-    if (overlap_n != NULL && response != NULL && fabs(overlap) < fabs(response->overlap)) {
-      response->overlap = overlap;
-      satc_point_copy(response->overlap_n, overlap_n);
+  // For B's axes, project from B's side. Both ranges end up relative to B's
+  // position instead of A's, which does not change how much they overlap.
+  satc_vec2_t reversed = satc_vec2_reverse(offset);
+  i = 0;
+  for (; i < b->num_points; i++) {
+    size_t twin = b->normal_twins[i];
+    if (twin < i) continue;
+    satc_vec2_store(axis, _satc_project_local(b, a, reversed, i, range_b, range_a));
+    if (_satc_is_separating_twin_range(range_a, range_b, axis, a->num_points + i, a->num_points + twin, &best_place, response)) {
+      return false;
     }
   }
 
   if (response != NULL) {
-    response->a = polygon;
-    response->b = circle;
+    response->a = a;
+    response->b = b;
     satc_point_copy(response->overlap_v, response->overlap_n);
     satc_point_scale_x(response->overlap_v, response->overlap);
   }
@@ -1486,70 +5415,639 @@ bool satc_test_polygon_circle (satc_polygon_t *polygon, satc_circle_t *circle, s
   return true;
 }
 
+
 /**
- * Checks to see if one circle and one polygon are overlapping.
+ * Get the position of a circle or a polygon, for the GJK tests.
  *
- * This is ever so slightly more expensive than `satc_test_polygon_circle`,
- * since the response data needs to be flipped after checking collision.
+ * For internal use.
  *
- * @param circle a circle.
- * @param polygon a polygon.
- * @param response the response object to set with collision data.
+ * @param shape a circle or a polygon.
+ * @return the position, as an array of doubles (a point).
  */
-bool satc_test_circle_polygon (satc_circle_t *circle, satc_polygon_t *polygon, satc_response_t *response) {
-  bool result = satc_test_polygon_circle(polygon, circle, response);
-  if (result && response != NULL) {
-    void *a = response->a;
-    bool a_in_b = response->a_in_b;
-    satc_point_reverse(response->overlap_n);
-    satc_point_reverse(response->overlap_v);
-    response->a = response->b;
-    response->b = a;
-    response->a_in_b = response->b_in_a;
-    response->b_in_a = a_in_b;
+SATC_REAL *_satc_gjk_pos (void *shape) {
+  // Every shape struct starts with its `type`.
+  if (*(int *) shape == satc_type_circle) return ((satc_circle_t *) shape)->pos;
+  return ((satc_polygon_t *) shape)->pos;
+}
+
+/**
+ * Get the radius a circle or a polygon adds around its core, for the GJK
+ * tests. See `_satc_gjk_support`.
+ *
+ * For internal use.
+ *
+ * @param shape a circle or a polygon.
+ * @return the radius of a circle, or `0` for a polygon.
+ */
+SATC_REAL _satc_gjk_radius (void *shape) {
+  if (*(int *) shape == satc_type_circle) return ((satc_circle_t *) shape)->r;
+  return 0.0;
+}
+
+/**
+ * Find the point of the core of a circle or a polygon which lies furthest
+ * along a direction, for the GJK tests. The core of a circle is its center
+ * and the core of a polygon is the polygon itself. The radius of a circle is
+ * only added back once the cores have been compared, so its curve never has
+ * to be approximated by points.
+ *
+ * Convex polygons whose normals can be searched are searched with
+ * `_satc_find_support` once they have `SATC_GJK_SEARCH_MIN_POINTS` points.
+ * Walking every point of a smaller polygon is quicker.
+ *
+ * For internal use.
+ *
+ * @param shape an up to date circle or polygon.
+ * @param origin_x the `x` value of the point the result is relative to.
+ * @param origin_y the `y` value of the point the result is relative to.
+ * @param dx the `x` value of the direction.
+ * @param dy the `y` value of the direction.
+ * @param result the array of two doubles (a point) to store the point in.
+ */
+void _satc_gjk_support (void *shape, SATC_REAL origin_x, SATC_REAL origin_y, SATC_REAL dx, SATC_REAL dy, SATC_REAL *result) {
+  SATC_REAL *pos = _satc_gjk_pos(shape);
+  SATC_REAL x = satc_point_get_x(pos) - origin_x;
+  SATC_REAL y = satc_point_get_y(pos) - origin_y;
+  if (*(int *) shape == satc_type_polygon) {
+    satc_polygon_t *polygon = shape;
+    size_t len = polygon->num_calc_points;
+    SATC_REAL *xs = polygon->calc_points.x;
+    SATC_REAL *ys = polygon->calc_points.y;
+    size_t best = 0;
+    // Walking a point costs less than a step of the search, so walking wins on small polygons.
+    if (polygon->normal_turn != 0 && len >= SATC_GJK_SEARCH_MIN_POINTS) {
+      best = _satc_find_support(len, xs, ys, 1, &polygon->normals, polygon->normal_turn, dx, dy);
+    } else {
+      SATC_REAL best_dot = xs[0] * dx + ys[0] * dy;
+      size_t i = 1;
+      for (; i < len; i++) {
+        SATC_REAL dot = xs[i] * dx + ys[i] * dy;
+        if (dot > best_dot) {
+          best = i;
+          best_dot = dot;
+        }
+      }
+    }
+    x += xs[best];
+    y += ys[best];
   }
+  satc_point_set_xy(result, x, y);
+}
 
-  return result;
+/**
+ * Find the point of the difference of the cores of two shapes (every point
+ * of `a` minus every point of `b`) which lies furthest along a direction.
+ * The shapes overlap when this difference holds the origin.
+ *
+ * For internal use.
+ *
+ * @param a an up to date circle or polygon.
+ * @param b another up to date circle or polygon.
+ * @param origin_x the `x` value of the position of `a`.
+ * @param origin_y the `y` value of the position of `a`.
+ * @param dx the `x` value of the direction.
+ * @param dy the `y` value of the direction.
+ * @param result the array of two doubles (a point) to store the point in.
+ */
+void _satc_gjk_support_difference (void *a, void *b, SATC_REAL origin_x, SATC_REAL origin_y, SATC_REAL dx, SATC_REAL dy, SATC_REAL *result) {
+  SATC_REAL point_a[2];
+  SATC_REAL point_b[2];
+  _satc_gjk_support(a, origin_x, origin_y, dx, dy, point_a);
+  _satc_gjk_support(b, origin_x, origin_y, -dx, -dy, point_b);
+  satc_point_set_xy(result, point_a[0] - point_b[0], point_a[1] - point_b[1]);
 }
 
 /**
- * Checks to see if one polygon and another are overlapping.
+ * Find how far along a segment its closest point to the origin lies.
  *
- * @param a a polygon.
- * @param b another polygon.
- * @param response the response object to set with collision data.
+ * For internal use.
+ *
+ * @param ax the `x` value of the start of the segment.
+ * @param ay the `y` value of the start of the segment.
+ * @param bx the `x` value of the end of the segment.
+ * @param by the `y` value of the end of the segment.
+ * @return a value from `0`, at the start, up to `1`, at the end.
  */
-bool satc_test_polygon_polygon (satc_polygon_t *a, satc_polygon_t *b, satc_response_t *response) {
-  double **a_points = a->calc_points;
-  size_t a_len = a->num_calc_points;
-  double **b_points = b->calc_points;
-  size_t b_len = b->num_calc_points;
+SATC_REAL _satc_segment_closest_to_origin (SATC_REAL ax, SATC_REAL ay, SATC_REAL bx, SATC_REAL by) {
+  SATC_REAL ex = bx - ax;
+  SATC_REAL ey = by - ay;
+  SATC_REAL len2 = ex * ex + ey * ey;
+  if (len2 <= 0.0) return 0.0;
+  SATC_REAL t = -(ax * ex + ay * ey) / len2;
+  if (t < 0.0) return 0.0;
+  if (t > 1.0) return 1.0;
+  return t;
+}
 
-  if (response != NULL) satc_response_clear(response);
-  if (a_len == 0 || b_len == 0) return false;
+/**
+ * Reduce a GJK simplex (a point, a segment, or a triangle) to the smallest
+ * part of it which holds its point closest to the origin, and find that
+ * point.
+ *
+ * For internal use.
+ *
+ * @param xs the `x` values of the points of the simplex.
+ * @param ys the `y` values of the points of the simplex.
+ * @param count the number of points in the simplex, which is updated as the
+ * simplex is reduced.
+ * @param closest the array of two doubles (a point) to store the closest
+ * point in.
+ * @return whether the simplex is a triangle around the origin, as a boolean.
+ */
+bool _satc_gjk_reduce (SATC_REAL *xs, SATC_REAL *ys, size_t *count, SATC_REAL *closest) {
+  if (*count == 3) {
+    SATC_REAL area = (xs[1] - xs[0]) * (ys[2] - ys[0]) - (ys[1] - ys[0]) * (xs[2] - xs[0]);
+    bool inside = area != 0.0;
+    size_t best = 0;
+    SATC_REAL best_len2 = SATC_REAL_MAX;
+    size_t i = 0;
+    for (; i < 3; i++) {
+      size_t j = i == 2 ? 0 : i + 1;
+      SATC_REAL cross = xs[i] * (ys[j] - ys[i]) - ys[i] * (xs[j] - xs[i]);
+      if (cross * area < 0.0) inside = false;
+      SATC_REAL t = _satc_segment_closest_to_origin(xs[i], ys[i], xs[j], ys[j]);
+      SATC_REAL x = xs[i] + t * (xs[j] - xs[i]);
+      SATC_REAL y = ys[i] + t * (ys[j] - ys[i]);
+      if (x * x + y * y < best_len2) {
+        best = i;
+        best_len2 = x * x + y * y;
+      }
+    }
+    if (inside) {
+      satc_point_set_xy(closest, 0.0, 0.0);
+      return true;
+    }
+    // Otherwise the closest point lies on an edge, which is all that is kept.
+    size_t next = best == 2 ? 0 : best + 1;
+    SATC_REAL x0 = xs[best];
+    SATC_REAL y0 = ys[best];
+    SATC_REAL x1 = xs[next];
+    SATC_REAL y1 = ys[next];
+    xs[0] = x0;
+    ys[0] = y0;
+    xs[1] = x1;
+    ys[1] = y1;
+    *count = 2;
+  }
+  if (*count == 2) {
+    SATC_REAL t = _satc_segment_closest_to_origin(xs[0], ys[0], xs[1], ys[1]);
+    if (t >= 1.0) {
+      xs[0] = xs[1];
+      ys[0] = ys[1];
+    }
+    if (t > 0.0 && t < 1.0) {
+      satc_point_set_xy(closest, xs[0] + t * (xs[1] - xs[0]), ys[0] + t * (ys[1] - ys[0]));
+      return false;
+    }
+    *count = 1;
+  }
+  satc_point_set_xy(closest, xs[0], ys[0]);
+  return false;
+}
+
+/**
+ * Run GJK on the cores of two shapes, to find the point of the difference
+ * of their cores closest to the origin, which is how far apart the cores
+ * are. Each step adds the support point towards the origin to a simplex and
+ * reduces the simplex to the part closest to the origin, so large hulls
+ * are done in a handful of steps rather than one per edge.
+ *
+ * The search stops as soon as the cores are shown to be more than `margin`
+ * apart.
+ *
+ * For internal use.
+ *
+ * @param a an up to date circle or polygon.
+ * @param b another up to date circle or polygon.
+ * @param origin_x the `x` value of the position of `a`.
+ * @param origin_y the `y` value of the position of `a`.
+ * @param margin how far apart the cores can be and still count as
+ * overlapping, which is the sum of the shapes' radii.
+ * @param xs an array of three doubles to store the `x` values of the final
+ * simplex in, relative to the position of `a`.
+ * @param ys an array of three doubles to store the `y` values of the final
+ * simplex in.
+ * @param count where to store the number of points in the final simplex.
+ * @param closest the array of two doubles (a point) to store the closest
+ * point in. It is zero when the cores overlap.
+ * @return whether the cores are no more than `margin` apart, as a boolean.
+ */
+bool _satc_gjk (void *a, void *b, SATC_REAL origin_x, SATC_REAL origin_y, SATC_REAL margin, SATC_REAL *xs, SATC_REAL *ys, size_t *count, SATC_REAL *closest) {
+  SATC_REAL tolerance = SATC_REAL_EPSILON * 64.0;
+  SATC_REAL *pos_b = _satc_gjk_pos(b);
+  SATC_REAL dx = origin_x - satc_point_get_x(pos_b);
+  SATC_REAL dy = origin_y - satc_point_get_y(pos_b);
+  if (dx == 0.0 && dy == 0.0) dx = 1.0;
+  SATC_REAL w[2];
+  _satc_gjk_support_difference(a, b, origin_x, origin_y, dx, dy, w);
+  xs[0] = w[0];
+  ys[0] = w[1];
+  *count = 1;
+  satc_point_copy(closest, w);
+  SATC_REAL scale2 = w[0] * w[0] + w[1] * w[1];
+
+  size_t iterations = 0;
+  for (; iterations < SATC_GJK_MAX_ITERATIONS; iterations++) {
+    SATC_REAL vx = closest[0];
+    SATC_REAL vy = closest[1];
+    SATC_REAL v_len2 = vx * vx + vy * vy;
+    // The cores touch.
+    if (v_len2 <= tolerance * tolerance * scale2) {
+      satc_point_set_xy(closest, 0.0, 0.0);
+      return true;
+    }
+    _satc_gjk_support_difference(a, b, origin_x, origin_y, -vx, -vy, w);
+    SATC_REAL vw = vx * w[0] + vy * w[1];
+    // No point of the difference is closer to the origin than `vw / |v|`.
+    if (vw > 0.0 && vw * vw > margin * margin * v_len2) return false;
+    // The new point gets no closer, so `v` is as close as it gets.
+    if (v_len2 - vw <= tolerance * v_len2) break;
+    xs[*count] = w[0];
+    ys[*count] = w[1];
+    *count += 1;
+    SATC_REAL w_len2 = w[0] * w[0] + w[1] * w[1];
+    if (w_len2 > scale2) scale2 = w_len2;
+    if (_satc_gjk_reduce(xs, ys, count, closest)) return true;
+    // Rounding can stall the search, which then settles for what it has.
+    if (satc_point_len2(closest) >= v_len2) break;
+  }
+
+  return satc_point_len2(closest) <= margin * margin;
+}
+
+/**
+ * Work out the outward unit normal of one edge of the polygon EPA grows,
+ * and its distance from the origin, for `_satc_epa`.
+ *
+ * For internal use.
+ *
+ * @param xs the `x` values of the polygon's points, counter-clockwise.
+ * @param ys the `y` values of the polygon's points.
+ * @param count the number of points.
+ * @param i the index of the edge, which starts at point `i`.
+ * @param normals_x the array to store the `x` value of the normal in.
+ * @param normals_y the array to store the `y` value of the normal in.
+ * @param dists the array to store the distance in, which is
+ * `SATC_REAL_MAX` if the edge has no length.
+ */
+void _satc_epa_edge (SATC_REAL *xs, SATC_REAL *ys, size_t count, size_t i, SATC_REAL *normals_x, SATC_REAL *normals_y, SATC_REAL *dists) {
+  size_t j = i == count - 1 ? 0 : i + 1;
+  SATC_REAL nx = ys[j] - ys[i];
+  SATC_REAL ny = xs[i] - xs[j];
+  SATC_REAL len = SATC_SQRT(nx * nx + ny * ny);
+  if (len == 0.0) {
+    normals_x[i] = 0.0;
+    normals_y[i] = 0.0;
+    dists[i] = SATC_REAL_MAX;
+    return;
+  }
+  normals_x[i] = nx / len;
+  normals_y[i] = ny / len;
+  dists[i] = normals_x[i] * xs[i] + normals_y[i] * ys[i];
+}
 
+/**
+ * Run EPA on the cores of two overlapping shapes, to find how far they
+ * overlap. The simplex GJK ended with is grown into a polygon inside the
+ * difference of the cores, by pushing out its edge closest to the origin
+ * to the support point along that edge's normal, until the edge can not be
+ * pushed out any further.
+ *
+ * For internal use.
+ *
+ * @param a an up to date circle or polygon.
+ * @param b another up to date circle or polygon.
+ * @param origin_x the `x` value of the position of `a`.
+ * @param origin_y the `y` value of the position of `a`.
+ * @param simplex_xs an array of three doubles holding the `x` values of the
+ * simplex GJK ended with.
+ * @param simplex_ys an array of three doubles holding the `y` values.
+ * @param count the number of points in the simplex.
+ * @param normal the array of two doubles (a point) to store the unit normal
+ * of the closest edge in, which points from `a` towards `b`.
+ * @return how far the cores overlap along the normal.
+ */
+SATC_REAL _satc_epa (void *a, void *b, SATC_REAL origin_x, SATC_REAL origin_y, SATC_REAL *simplex_xs, SATC_REAL *simplex_ys, size_t count, SATC_REAL *normal) {
+  SATC_REAL tolerance = SATC_REAL_EPSILON * 64.0;
+  SATC_REAL xs[SATC_GJK_MAX_ITERATIONS + 3];
+  SATC_REAL ys[SATC_GJK_MAX_ITERATIONS + 3];
+  SATC_REAL w[2];
   size_t i = 0;
-  for (; i < a_len; i++) {
-    if (satc_is_separating_axis(a->pos, b->pos, a_len, a_points, b_len, b_points, a->normals[i], response)) {
-      return false;
+  for (; i < 3; i++) {
+    xs[i] = simplex_xs[i];
+    ys[i] = simplex_ys[i];
+  }
+
+  // Cores which only touch can leave GJK with a point or a segment, which
+  // has to be grown into a triangle first.
+  if (count == 1) {
+    _satc_gjk_support_difference(a, b, origin_x, origin_y, 1.0, 0.0, w);
+    if (w[0] == xs[0] && w[1] == ys[0]) _satc_gjk_support_difference(a, b, origin_x, origin_y, -1.0, 0.0, w);
+    if (w[0] == xs[0] && w[1] == ys[0]) {
+      satc_point_set_xy(normal, 1.0, 0.0);
+      return 0.0;
+    }
+    xs[1] = w[0];
+    ys[1] = w[1];
+    count = 2;
+  }
+  SATC_REAL ex = xs[1] - xs[0];
+  SATC_REAL ey = ys[1] - ys[0];
+  SATC_REAL area = 0.0;
+  if (count == 2) {
+    _satc_gjk_support_difference(a, b, origin_x, origin_y, ey, -ex, w);
+    area = ex * (w[1] - ys[0]) - ey * (w[0] - xs[0]);
+    if (area == 0.0) {
+      _satc_gjk_support_difference(a, b, origin_x, origin_y, -ey, ex, w);
+      area = ex * (w[1] - ys[0]) - ey * (w[0] - xs[0]);
+    }
+    // The difference is flat, so the cores only touch.
+    if (area == 0.0) {
+      satc_point_set_xy(normal, ey, -ex);
+      satc_point_normalize(normal);
+      return 0.0;
     }
+    xs[2] = w[0];
+    ys[2] = w[1];
+    count = 3;
+  } else {
+    area = ex * (ys[2] - ys[0]) - ey * (xs[2] - xs[0]);
+  }
+  // Wind the polygon counter-clockwise, so the edges' normals face outwards.
+  if (area < 0.0) {
+    SATC_REAL x = xs[1];
+    SATC_REAL y = ys[1];
+    xs[1] = xs[2];
+    ys[1] = ys[2];
+    xs[2] = x;
+    ys[2] = y;
   }
 
-  i = 0;
-  for (; i < b_len; i++) {
-    if (satc_is_separating_axis(a->pos, b->pos, a_len, a_points, b_len, b_points, b->normals[i], response)) {
-      return false;
+  // The unit normal and distance from the origin of each edge are kept, so
+  // only the two edges a new point makes have to be worked out.
+  SATC_REAL normals_x[SATC_GJK_MAX_ITERATIONS + 3];
+  SATC_REAL normals_y[SATC_GJK_MAX_ITERATIONS + 3];
+  SATC_REAL dists[SATC_GJK_MAX_ITERATIONS + 3];
+  for (i = 0; i < count; i++) _satc_epa_edge(xs, ys, count, i, normals_x, normals_y, dists);
+
+  SATC_REAL depth = 0.0;
+  satc_point_set_xy(normal, 1.0, 0.0);
+  size_t iterations = 0;
+  for (; iterations < SATC_GJK_MAX_ITERATIONS; iterations++) {
+    size_t best = 0;
+    for (i = 1; i < count; i++) {
+      if (dists[i] < dists[best]) best = i;
     }
+    if (dists[best] == SATC_REAL_MAX) break;
+    depth = dists[best];
+    satc_point_set_xy(normal, normals_x[best], normals_y[best]);
+    _satc_gjk_support_difference(a, b, origin_x, origin_y, normal[0], normal[1], w);
+    SATC_REAL w_dist = normal[0] * w[0] + normal[1] * w[1];
+    // The closest edge is an edge of the difference itself.
+    if (w_dist - depth <= tolerance * SATC_FABS(w_dist)) break;
+    for (i = count; i > best + 1; i--) {
+      xs[i] = xs[i - 1];
+      ys[i] = ys[i - 1];
+      normals_x[i] = normals_x[i - 1];
+      normals_y[i] = normals_y[i - 1];
+      dists[i] = dists[i - 1];
+    }
+    xs[best + 1] = w[0];
+    ys[best + 1] = w[1];
+    count++;
+    _satc_epa_edge(xs, ys, count, best, normals_x, normals_y, dists);
+    _satc_epa_edge(xs, ys, count, best + 1, normals_x, normals_y, dists);
   }
 
-  if (response != NULL) {
-    response->a = a;
-    response->b = b;
-    satc_point_copy(response->overlap_v, response->overlap_n);
-    satc_point_scale_x(response->overlap_v, response->overlap);
+  return depth > 0.0 ? depth : 0.0;
+}
+
+/**
+ * Whether one shape lies inside another, for the GJK tests. A polygon
+ * inside a circle has every point within the circle's radius. A shape
+ * inside a polygon has its range along each of the polygon's normals within
+ * the polygon's own range, as with `satc_test_polygon_polygon`.
+ *
+ * For internal use.
+ *
+ * @param outer an up to date circle or polygon.
+ * @param inner another up to date circle or polygon.
+ * @return whether `inner` lies inside `outer`, as a boolean.
+ */
+bool _satc_gjk_contains (void *outer, void *inner) {
+  SATC_REAL *pos = _satc_gjk_pos(outer);
+  SATC_REAL origin_x = satc_point_get_x(pos);
+  SATC_REAL origin_y = satc_point_get_y(pos);
+  SATC_REAL inner_radius = _satc_gjk_radius(inner);
+  SATC_REAL point[2];
+
+  if (*(int *) outer == satc_type_circle) {
+    SATC_REAL radius = ((satc_circle_t *) outer)->r;
+    if (*(int *) inner == satc_type_circle) {
+      _satc_gjk_support(inner, origin_x, origin_y, 1.0, 0.0, point);
+      return inner_radius <= radius && satc_point_len(point) <= radius - inner_radius;
+    }
+    satc_polygon_t *polygon = inner;
+    SATC_REAL x = satc_point_get_x(polygon->pos) - origin_x;
+    SATC_REAL y = satc_point_get_y(polygon->pos) - origin_y;
+    size_t i = 0;
+    for (; i < polygon->num_calc_points; i++) {
+      SATC_REAL px = x + polygon->calc_points.x[i];
+      SATC_REAL py = y + polygon->calc_points.y[i];
+      if (px * px + py * py > radius * radius) return false;
+    }
+    return true;
+  }
+
+  satc_polygon_t *polygon = outer;
+  SATC_REAL range[2];
+  size_t i = 0;
+  for (; i < polygon->num_calc_points; i++) {
+    if (polygon->normal_twins[i] < i) continue;
+    SATC_REAL nx = polygon->normals.x[i];
+    SATC_REAL ny = polygon->normals.y[i];
+    _satc_polygon_own_range(polygon, i, range);
+    _satc_gjk_support(inner, origin_x, origin_y, -nx, -ny, point);
+    if (point[0] * nx + point[1] * ny - inner_radius < range[0]) return false;
+    _satc_gjk_support(inner, origin_x, origin_y, nx, ny, point);
+    if (point[0] * nx + point[1] * ny + inner_radius > range[1]) return false;
   }
+  return true;
+}
 
+/**
+ * Test two up to date shapes with GJK and EPA, for the `satc_gjk_test_*`
+ * functions.
+ *
+ * For internal use.
+ *
+ * @param a a circle or a polygon with at least one point.
+ * @param b another circle or polygon with at least one point.
+ * @param response the response object to set with collision data, which
+ * has already been cleared.
+ * @return whether the shapes overlap, as a boolean.
+ */
+bool _satc_gjk_test (void *a, void *b, satc_response_t *response) {
+  SATC_REAL *pos = _satc_gjk_pos(a);
+  SATC_REAL origin_x = satc_point_get_x(pos);
+  SATC_REAL origin_y = satc_point_get_y(pos);
+  SATC_REAL radius = _satc_gjk_radius(a) + _satc_gjk_radius(b);
+  SATC_REAL xs[3] = { 0.0, 0.0, 0.0 };
+  SATC_REAL ys[3] = { 0.0, 0.0, 0.0 };
+  size_t count = 0;
+  SATC_REAL closest[2];
+  if (!_satc_gjk(a, b, origin_x, origin_y, radius, xs, ys, &count, closest)) return false;
+  if (response == NULL) return true;
+
+  SATC_REAL dist = satc_point_len(closest);
+  if (dist > 0.0) {
+    // Only the radii overlap, along the line between the closest points.
+    satc_point_set_xy(response->overlap_n, -closest[0] / dist, -closest[1] / dist);
+    response->overlap = radius - dist;
+  } else {
+    response->overlap = _satc_epa(a, b, origin_x, origin_y, xs, ys, count, response->overlap_n) + radius;
+  }
+  response->a = a;
+  response->b = b;
+  satc_point_copy(response->overlap_v, response->overlap_n);
+  satc_point_scale_x(response->overlap_v, response->overlap);
+  response->a_in_b = _satc_gjk_contains(b, a);
+  response->b_in_a = _satc_gjk_contains(a, b);
   return true;
 }
 
+/**
+ * Checks to see if one polygon and another are overlapping, with GJK rather
+ * than the separating axis test.
+ *
+ * GJK only ever looks at the polygons through the point of each furthest
+ * along a direction, and usually settles in a handful of steps, however
+ * many edges the polygons have. When they overlap and there is a response,
+ * EPA then works out how far. The response is set just as by
+ * `satc_test_polygon_polygon`, up to rounding, and like it, the polygons
+ * are treated as convex.
+ *
+ * @param a a polygon.
+ * @param b another polygon.
+ * @param response the response object to set with collision data.
+ * @return whether the polygons overlap, as a boolean.
+ */
+bool satc_gjk_test_polygon_polygon (satc_polygon_t *a, satc_polygon_t *b, satc_response_t *response) {
+  satc_polygon_update(a);
+  satc_polygon_update(b);
+  if (response != NULL) satc_response_clear(response);
+  if (a->num_calc_points == 0 || b->num_calc_points == 0) return false;
+
+  // Polygons whose bounding boxes do not overlap can not collide.
+  satc_aabb_t a_aabb;
+  satc_aabb_t b_aabb;
+  satc_polygon_get_bounds(a, &a_aabb);
+  satc_polygon_get_bounds(b, &b_aabb);
+  if (!satc_aabb_overlaps(&a_aabb, &b_aabb)) return false;
+
+  return _satc_gjk_test(a, b, response);
+}
+
+/**
+ * Checks to see if a polygon and a circle are overlapping, with GJK rather
+ * than the separating axis test.
+ *
+ * The circle is handled as its center plus its radius, so its curve never
+ * slows GJK or EPA down. The response is set just as by
+ * `satc_test_polygon_circle`, up to rounding.
+ *
+ * @param polygon a polygon.
+ * @param circle a circle.
+ * @param response the response object to set with collision data.
+ * @return whether the polygon and circle overlap, as a boolean.
+ */
+bool satc_gjk_test_polygon_circle (satc_polygon_t *polygon, satc_circle_t *circle, satc_response_t *response) {
+  satc_polygon_update(polygon);
+  if (response != NULL) satc_response_clear(response);
+  if (polygon->num_calc_points == 0) return false;
+  return _satc_gjk_test(polygon, circle, response);
+}
+
+/**
+ * Checks to see if a circle and a polygon are overlapping, with GJK rather
+ * than the separating axis test. See `satc_gjk_test_polygon_circle`.
+ *
+ * @param circle a circle.
+ * @param polygon a polygon.
+ * @param response the response object to set with collision data.
+ * @return whether the circle and polygon overlap, as a boolean.
+ */
+bool satc_gjk_test_circle_polygon (satc_circle_t *circle, satc_polygon_t *polygon, satc_response_t *response) {
+  satc_polygon_update(polygon);
+  if (response != NULL) satc_response_clear(response);
+  if (polygon->num_calc_points == 0) return false;
+  return _satc_gjk_test(circle, polygon, response);
+}
+
+/**
+ * Find the distance between two shapes with GJK.
+ *
+ * @param a a circle or a polygon.
+ * @param b another circle or polygon.
+ * @return the distance between the closest points of the shapes, or `0` if
+ * they overlap, or `SATC_REAL_MAX` if either is a polygon without points.
+ */
+SATC_REAL satc_gjk_distance (void *a, void *b) {
+  if (*(int *) a == satc_type_polygon) {
+    satc_polygon_update(a);
+    if (((satc_polygon_t *) a)->num_calc_points == 0) return SATC_REAL_MAX;
+  }
+  if (*(int *) b == satc_type_polygon) {
+    satc_polygon_update(b);
+    if (((satc_polygon_t *) b)->num_calc_points == 0) return SATC_REAL_MAX;
+  }
+  SATC_REAL *pos = _satc_gjk_pos(a);
+  SATC_REAL radius = _satc_gjk_radius(a) + _satc_gjk_radius(b);
+  SATC_REAL xs[3];
+  SATC_REAL ys[3];
+  size_t count = 0;
+  SATC_REAL closest[2];
+  _satc_gjk(a, b, satc_point_get_x(pos), satc_point_get_y(pos), SATC_REAL_MAX, xs, ys, &count, closest);
+  SATC_REAL dist = satc_point_len(closest) - radius;
+  return dist > 0.0 ? dist : 0.0;
+}
+
+/**
+ * Checks to see if two shapes are overlapping, with the separating axis
+ * test or with GJK, so the algorithm can be chosen for each pair of shapes.
+ * Two circles are always tested directly, with `satc_test_circle_circle`.
+ *
+ * @param a a circle or a polygon.
+ * @param b another circle or polygon.
+ * @param narrowphase `satc_narrowphase_sat` or `satc_narrowphase_gjk`.
+ * @param response the response object to set with collision data.
+ * @return whether the shapes overlap, as a boolean. Shapes of any other type
+ * never overlap.
+ */
+bool satc_test_shapes (void *a, void *b, int narrowphase, satc_response_t *response) {
+  int a_type = *(int *) a;
+  int b_type = *(int *) b;
+  bool gjk = narrowphase == satc_narrowphase_gjk;
+  if (a_type == satc_type_circle && b_type == satc_type_circle) {
+    return satc_test_circle_circle(a, b, response);
+  }
+  if (a_type == satc_type_polygon && b_type == satc_type_polygon) {
+    return gjk ? satc_gjk_test_polygon_polygon(a, b, response) : satc_test_polygon_polygon(a, b, response);
+  }
+  if (a_type == satc_type_polygon && b_type == satc_type_circle) {
+    return gjk ? satc_gjk_test_polygon_circle(a, b, response) : satc_test_polygon_circle(a, b, response);
+  }
+  if (a_type == satc_type_circle && b_type == satc_type_polygon) {
+    return gjk ? satc_gjk_test_circle_polygon(a, b, response) : satc_test_circle_polygon(a, b, response);
+  }
+  if (response != NULL) satc_response_clear(response);
+  return false;
+}
+
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT DEFAULT
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
 #endif